@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <libtech/concurrent_hashmap.hpp>
+#include <libtech/hashmap.hpp>
+#include <libtech/read_mostly_hashmap.hpp>
+#include <mutex>
+#include <random>
+
+namespace {
+constexpr std::uint64_t KEY_RANGE = 1 << 20;
+
+// то, с чем сравниваем: обычный HashMap за одним мьютексом
+class LockedMap {
+  public:
+	bool contains(std::uint64_t key) const {
+		std::lock_guard lock(mutex);
+		return map.contains(key);
+	}
+	void upsert(std::uint64_t key) {
+		std::lock_guard lock(mutex);
+		++map[key];
+	}
+	void reserve(std::size_t count) { map.reserve(count); }
+
+  private:
+	mutable std::mutex mutex;
+	tech::HashMap<std::uint64_t, std::uint64_t> map;
+};
+
+class ShardedMap {
+  public:
+	bool contains(std::uint64_t key) const { return map.contains(key); }
+	void upsert(std::uint64_t key) {
+		map.upsert(key, [](std::uint64_t& value) { ++value; }, 1);
+	}
+	void reserve(std::size_t count) { map.reserve(count); }
+
+  private:
+	tech::ConcurrentHashMap<std::uint64_t, std::uint64_t> map;
+};
+
+// читатели без блокировок, запись заменяет ноду
+class ReadMostlyMap {
+  public:
+	bool contains(std::uint64_t key) const { return map.contains(key); }
+	void upsert(std::uint64_t key) {
+		map.upsert(key, [](std::uint64_t& value) { ++value; }, 1);
+	}
+	void reserve(std::size_t count) { map.reserve(count); }
+
+  private:
+	tech::ReadMostlyHashMap<std::uint64_t, std::uint64_t> map;
+};
+
+// общая на все потоки карта, заполнена половиной ключей, чтобы поиск давал и попадания, и промахи
+template <class Map> Map& shared_map() {
+	static Map map;
+	static const bool filled = [] {
+		map.reserve(KEY_RANGE);
+		for (std::uint64_t key = 0; key < KEY_RANGE; key += 2) {
+			map.upsert(key);
+		}
+		return true;
+	}();
+	benchmark::DoNotOptimize(filled);
+	return map;
+}
+
+// WritePercent процентов операций пишут, остальные читают
+template <class Map, int WritePercent> void BM_Mixed(benchmark::State& state) {
+	auto& map = shared_map<Map>();
+	std::mt19937_64 gen(state.thread_index() + 1);
+	std::uniform_int_distribution<std::uint64_t> keys(0, KEY_RANGE - 1);
+	std::uniform_int_distribution<int> percent(0, 99);
+	for (auto _ : state) {
+		auto key = keys(gen);
+		if (percent(gen) < WritePercent) {
+			map.upsert(key);
+		} else {
+			benchmark::DoNotOptimize(map.contains(key));
+		}
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Mixed, LockedMap, 0)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Mixed, ShardedMap, 0)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Mixed, ReadMostlyMap, 0)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Mixed, LockedMap, 5)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Mixed, ShardedMap, 5)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Mixed, ReadMostlyMap, 5)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Mixed, LockedMap, 50)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Mixed, ShardedMap, 50)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Mixed, ReadMostlyMap, 50)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <functional>
+#include <libtech/growth_policy.hpp>
+#include <libtech/hash.hpp>
+#include <libtech/hashmap.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+// скорость самих хешей по типам ключей и то, что они дают таблице на последовательных id
+namespace {
+constexpr std::size_t KEYS_COUNT = 1 << 12;
+
+template <class Hash> void BM_HashInt(benchmark::State& state) {
+	std::vector<std::uint64_t> keys(KEYS_COUNT);
+	std::mt19937_64 gen(1);
+	for (auto& key : keys) {
+		key = gen();
+	}
+	Hash hash;
+	for (auto _ : state) {
+		std::size_t sum = 0;
+		for (auto key : keys) {
+			sum += hash(key);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * KEYS_COUNT);
+}
+
+template <class Hash> void BM_HashString(benchmark::State& state) {
+	const auto length = static_cast<std::size_t>(state.range(0));
+	std::vector<std::string> keys(KEYS_COUNT / 16);
+	std::mt19937_64 gen(1);
+	for (auto& key : keys) {
+		key.resize(length);
+		for (auto& c : key) {
+			c = static_cast<char>('a' + gen() % 26);
+		}
+	}
+	Hash hash;
+	for (auto _ : state) {
+		std::size_t sum = 0;
+		for (const auto& key : keys) {
+			sum += hash(key);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * keys.size());
+	state.SetBytesProcessed(state.iterations() * keys.size() * length);
+}
+
+// id подряд с шагом 1024 и ведра степенью двойки - худший случай для тождественного хеша.
+// Таблица сама перемешивает std::hash, так что разница тут - цена этого перемешивания
+template <class Hash> void BM_SequentialIdInsert(benchmark::State& state) {
+	const auto size = static_cast<std::uint64_t>(state.range(0));
+	for (auto _ : state) {
+		tech::HashMap<std::uint64_t, std::uint64_t, Hash, std::equal_to<std::uint64_t>,
+					  std::allocator<std::pair<std::uint64_t, std::uint64_t>>, tech::PowerOfTwoGrowthPolicy<>>
+			map;
+		for (std::uint64_t id = 0; id < size; ++id) {
+			map.emplace(id << 10, id);
+		}
+		benchmark::DoNotOptimize(map.size());
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_HashInt, std::hash<std::uint64_t>);
+BENCHMARK_TEMPLATE(BM_HashInt, tech::Hash<std::uint64_t>);
+BENCHMARK_TEMPLATE(BM_HashString, std::hash<std::string>)->RangeMultiplier(2)->Range(8, 1024);
+BENCHMARK_TEMPLATE(BM_HashString, tech::Hash<std::string>)->RangeMultiplier(2)->Range(8, 1024);
+BENCHMARK_TEMPLATE(BM_SequentialIdInsert, std::hash<std::uint64_t>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_SequentialIdInsert, tech::Hash<std::uint64_t>)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,356 @@
+#include "memory_stats.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <functional>
+#include <libtech/flat_hashmap.hpp>
+#include <libtech/hash_multimap.hpp>
+#include <libtech/hash_set.hpp>
+#include <libtech/hashmap.hpp>
+#include <libtech/parallel.hpp>
+#include <libtech/uniqueptr.hpp>
+#include <random>
+#include <span>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+std::vector<std::uint64_t> make_keys(std::size_t count, std::uint64_t seed) {
+	std::mt19937_64 gen(seed);
+	std::vector<std::uint64_t> keys(count);
+	for (auto& key : keys) {
+		key = gen();
+	}
+	return keys;
+}
+
+template <class Map> Map make_map(const std::vector<std::uint64_t>& keys) {
+	Map map;
+	map.reserve(keys.size());
+	for (auto key : keys) {
+		map.emplace(key, key);
+	}
+	return map;
+}
+
+// ключи берём вразнобой, чтобы не попадать в кеш по порядку вставки
+template <class Map> void BM_FindHit(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto keys = make_keys(size, 1);
+	auto map = make_map<Map>(keys);
+	std::shuffle(keys.begin(), keys.end(), std::mt19937_64(2));
+	std::size_t i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(map.find(keys[i]));
+		if (++i == size) {
+			i = 0;
+		}
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+template <class Map> void BM_FindMiss(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto map = make_map<Map>(make_keys(size, 1));
+	auto missing = make_keys(size, 3);
+	std::size_t i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(map.contains(missing[i]));
+		if (++i == size) {
+			i = 0;
+		}
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+// пачки ключей как у join: обычный цикл по find против find_many с prefetch
+constexpr std::size_t PROBE_BATCH = 1024;
+
+void BM_FindLoop(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto keys = make_keys(size, 1);
+	auto map = make_map<tech::HashMap<std::uint64_t, std::uint64_t>>(keys);
+	std::shuffle(keys.begin(), keys.end(), std::mt19937_64(2));
+	std::size_t offset = 0;
+	for (auto _ : state) {
+		std::uint64_t sum = 0;
+		for (std::size_t i = 0; i < PROBE_BATCH; ++i) {
+			sum += map.find(keys[offset + i])->second;
+		}
+		benchmark::DoNotOptimize(sum);
+		offset = offset + 2 * PROBE_BATCH > size ? 0 : offset + PROBE_BATCH;
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(PROBE_BATCH));
+}
+
+void BM_FindMany(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto keys = make_keys(size, 1);
+	auto map = make_map<tech::HashMap<std::uint64_t, std::uint64_t>>(keys);
+	std::shuffle(keys.begin(), keys.end(), std::mt19937_64(2));
+	std::vector<std::uint64_t*> results(PROBE_BATCH);
+	std::size_t offset = 0;
+	for (auto _ : state) {
+		map.find_many(std::span<const std::uint64_t>(keys.data() + offset, PROBE_BATCH), std::span(results));
+		std::uint64_t sum = 0;
+		for (auto* value : results) {
+			sum += *value;
+		}
+		benchmark::DoNotOptimize(sum);
+		offset = offset + 2 * PROBE_BATCH > size ? 0 : offset + PROBE_BATCH;
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(PROBE_BATCH));
+}
+
+// снимок в памяти: меряется сама (де)сериализация, без диска
+void BM_Save(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto map = make_map<tech::HashMap<std::uint64_t, std::uint64_t>>(make_keys(size, 1));
+	std::size_t bytes = 0;
+	for (auto _ : state) {
+		std::stringstream stream;
+		map.save(stream);
+		bytes = stream.str().size();
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes));
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+void BM_Load(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	std::stringstream stream;
+	make_map<tech::HashMap<std::uint64_t, std::uint64_t>>(make_keys(size, 1)).save(stream);
+	const auto image = stream.str();
+	for (auto _ : state) {
+		state.PauseTiming();
+		std::stringstream in(image);
+		tech::HashMap<std::uint64_t, std::uint64_t> map;
+		state.ResumeTiming();
+		map.load(in);
+		benchmark::DoNotOptimize(map.size());
+		state.PauseTiming();
+		map = {};
+		state.ResumeTiming();
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(image.size()));
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+// масштабирование rehash и clear по потокам: range(1) потоков, 1 - последовательный вариант.
+// Таблица попеременно растет вдвое и сжимается обратно
+void BM_ParallelRehash(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	const auto threads = static_cast<std::size_t>(state.range(1));
+	auto map = make_map<tech::HashMap<std::uint64_t, std::uint64_t>>(make_keys(size, 1));
+	bool grow = true;
+	for (auto _ : state) {
+		auto count = grow ? 2 * map.bucket_count() : 0;
+		if (threads == 1) {
+			map.rehash(tech::execution::seq, count);
+		} else {
+			map.rehash(tech::execution::parallel_policy{threads}, count);
+		}
+		grow = !grow;
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+void BM_ParallelClear(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	const auto threads = static_cast<std::size_t>(state.range(1));
+	const auto keys = make_keys(size, 1);
+	for (auto _ : state) {
+		state.PauseTiming();
+		auto map = make_map<tech::HashMap<std::uint64_t, std::uint64_t>>(keys);
+		state.ResumeTiming();
+		if (threads == 1) {
+			map.clear(tech::execution::seq);
+		} else {
+			map.clear(tech::execution::parallel_policy{threads});
+		}
+		benchmark::DoNotOptimize(map.size());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+// сумма значений: range(1) потоков через parallel_reduce, 1 - обычный обход итератором
+void BM_ParallelReduce(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	const auto threads = static_cast<std::size_t>(state.range(1));
+	const auto map = make_map<tech::HashMap<std::uint64_t, std::uint64_t>>(make_keys(size, 1));
+	auto add = [](std::uint64_t acc, const auto& value) { return acc + value.second; };
+	for (auto _ : state) {
+		std::uint64_t sum = 0;
+		if (threads == 1) {
+			for (const auto& value : map) {
+				sum = add(sum, value);
+			}
+		} else {
+			sum = tech::parallel_reduce(tech::execution::parallel_policy{threads}, map, std::uint64_t{0}, add);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+void BM_ParallelForEach(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	const auto threads = static_cast<std::size_t>(state.range(1));
+	auto map = make_map<tech::HashMap<std::uint64_t, std::uint64_t>>(make_keys(size, 1));
+	auto touch = [](auto& value) { value.second = value.second * 3 + 1; };
+	for (auto _ : state) {
+		if (threads == 1) {
+			std::for_each(map.begin(), map.end(), touch);
+		} else {
+			tech::parallel_for_each(tech::execution::parallel_policy{threads}, map, touch);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+template <class Policy> void BM_Insert(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto keys = make_keys(size, 1);
+	for (auto _ : state) {
+		tech::HashMap<std::uint64_t, std::uint64_t, std::hash<std::uint64_t>,
+					  std::equal_to<std::uint64_t>, std::allocator<std::pair<std::uint64_t, std::uint64_t>>, Policy>
+			map;
+		for (auto key : keys) {
+			map.emplace(key, key);
+		}
+		benchmark::DoNotOptimize(map.size());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+// так выглядели ведра до встраивания значения в ноду: нода, отдельная аллокация
+// под значение и std::function в качестве удалителя
+template <class Value> class LegacyLayout {
+	struct Node {
+		tech::UniquePtr<Value, std::function<void(Value*)>> value;
+		Node* next;
+		Node* prev;
+	};
+	struct Bucket {
+		Node* first = nullptr;
+		Node* last = nullptr;
+		std::size_t count = 0;
+	};
+	std::vector<Bucket> buckets;
+
+  public:
+	void reserve(std::size_t count) { buckets.resize(count); }
+	template <class... Args> void emplace(Args&&... args) {
+		auto* value = std::allocator<Value>().allocate(1);
+		std::construct_at(value, std::forward<Args>(args)...);
+		auto* node = new Node{decltype(Node::value)(value,
+													[](Value* ptr) {
+														std::destroy_at(ptr);
+														std::allocator<Value>().deallocate(ptr, 1);
+													}),
+							  nullptr, nullptr};
+		auto& bucket = buckets[std::hash<decltype(value->first)>{}(value->first) % buckets.size()];
+		node->prev = bucket.last;
+		(bucket.last ? bucket.last->next : bucket.first) = node;
+		bucket.last = node;
+		++bucket.count;
+	}
+	~LegacyLayout() {
+		for (auto& bucket : buckets) {
+			while (bucket.first) {
+				delete std::exchange(bucket.first, bucket.first->next);
+			}
+		}
+	}
+};
+
+template <class Map> void BM_Footprint(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto keys = make_keys(size, 1);
+	for (auto _ : state) {
+		auto before = bench::memory_stats();
+		{
+			auto map = make_map<Map>(keys);
+			auto after = bench::memory_stats();
+			state.counters["bytes_per_entry"] = static_cast<double>(after.live_bytes - before.live_bytes) / static_cast<double>(size);
+			state.counters["allocs_per_entry"] = static_cast<double>(after.allocations - before.allocations) / static_cast<double>(size);
+		}
+	}
+}
+
+// дедупликация и группировка потока с повторами: range(1) записей на ключ. Как было - HashMap<Key, bool>
+// и HashMap<Key, std::vector<V>>, как стало - HashSet и HashMultiMap
+using DedupMap = tech::HashMap<std::uint64_t, bool>;
+using DedupSet = tech::HashSet<std::uint64_t>;
+using GroupMap = tech::HashMap<std::uint64_t, std::vector<std::uint64_t>>;
+using GroupMultiMap = tech::HashMultiMap<std::uint64_t, std::uint64_t>;
+
+void add_record(DedupMap& map, std::uint64_t key, std::uint64_t /*value*/) { map.emplace(key, true); }
+void add_record(DedupSet& set, std::uint64_t key, std::uint64_t /*value*/) { set.insert(key); }
+void add_record(GroupMap& map, std::uint64_t key, std::uint64_t value) { map[key].push_back(value); }
+void add_record(GroupMultiMap& map, std::uint64_t key, std::uint64_t value) { map.emplace(key, value); }
+
+template <class Container> void BM_Grouping(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto keys = make_keys(size / static_cast<std::size_t>(state.range(1)), 1);
+	std::vector<std::uint64_t> records(size);
+	std::mt19937_64 gen(2);
+	for (auto& record : records) {
+		record = keys[gen() % keys.size()];
+	}
+	for (auto _ : state) {
+		auto before = bench::memory_stats();
+		Container container;
+		for (std::size_t i = 0; i < size; ++i) {
+			add_record(container, records[i], i);
+		}
+		auto after = bench::memory_stats();
+		state.counters["bytes_per_record"] = static_cast<double>(after.live_bytes - before.live_bytes) / static_cast<double>(size);
+		state.counters["allocs_per_record"] = static_cast<double>(after.allocations - before.allocations) / static_cast<double>(size);
+		benchmark::DoNotOptimize(container.size());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+} // namespace
+
+using Entry = std::pair<std::uint64_t, std::uint64_t>;
+using LegacyMap = LegacyLayout<Entry>;
+using StdMap = std::unordered_map<std::uint64_t, std::uint64_t>;
+
+BENCHMARK_TEMPLATE(BM_Footprint, LegacyMap)->Arg(1'000'000)->Iterations(1);
+BENCHMARK_TEMPLATE(BM_Footprint, tech::HashMap<std::uint64_t, std::uint64_t>)->Arg(1'000'000)->Iterations(1);
+BENCHMARK_TEMPLATE(BM_Footprint, tech::FlatHashMap<std::uint64_t, std::uint64_t>)->Arg(1'000'000)->Iterations(1);
+BENCHMARK_TEMPLATE(BM_Footprint, StdMap)->Arg(1'000'000)->Iterations(1);
+
+BENCHMARK_TEMPLATE(BM_Insert, tech::PrimeGrowthPolicy<>)->RangeMultiplier(10)->Range(1'000, 1'000'000);
+BENCHMARK_TEMPLATE(BM_Insert, tech::PowerOfTwoGrowthPolicy<>)->RangeMultiplier(10)->Range(1'000, 1'000'000);
+BENCHMARK_TEMPLATE(BM_Insert, tech::ModuloGrowthPolicy<std::ratio<3, 2>>)->RangeMultiplier(10)->Range(1'000, 1'000'000);
+using ChainedMap = tech::HashMap<std::uint64_t, std::uint64_t>;
+using FlatMap = tech::FlatHashMap<std::uint64_t, std::uint64_t>;
+
+BENCHMARK_TEMPLATE(BM_FindHit, ChainedMap)->RangeMultiplier(10)->Range(1'000, 10'000'000);
+BENCHMARK_TEMPLATE(BM_FindMiss, ChainedMap)->RangeMultiplier(10)->Range(1'000, 10'000'000);
+BENCHMARK_TEMPLATE(BM_FindHit, FlatMap)->RangeMultiplier(10)->Range(1'000, 10'000'000);
+BENCHMARK_TEMPLATE(BM_FindMiss, FlatMap)->RangeMultiplier(10)->Range(1'000, 10'000'000);
+
+BENCHMARK(BM_FindLoop)->RangeMultiplier(10)->Range(10'000, 10'000'000);
+BENCHMARK(BM_FindMany)->RangeMultiplier(10)->Range(10'000, 10'000'000);
+
+BENCHMARK(BM_Save)->RangeMultiplier(10)->Range(10'000, 1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Load)->RangeMultiplier(10)->Range(10'000, 1'000'000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_ParallelRehash)->ArgsProduct({{1'000'000, 10'000'000}, {1, 2, 4, 8}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ParallelClear)->ArgsProduct({{1'000'000, 10'000'000}, {1, 2, 4, 8}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ParallelReduce)->ArgsProduct({{4'000'000}, {1, 8, 16, 32}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ParallelForEach)->ArgsProduct({{4'000'000}, {1, 8, 16, 32}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Grouping, DedupMap)->ArgsProduct({{1'000'000}, {2, 8}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Grouping, DedupSet)->ArgsProduct({{1'000'000}, {2, 8}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Grouping, GroupMap)->ArgsProduct({{1'000'000}, {2, 8}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Grouping, GroupMultiMap)->ArgsProduct({{1'000'000}, {2, 8}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
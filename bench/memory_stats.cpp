@@ -0,0 +1,62 @@
+#include "memory_stats.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if __has_include(<sys/resource.h>)
+#include <sys/resource.h>
+#define LIBTECH_BENCH_RUSAGE 1
+#endif
+
+namespace {
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> allocated_bytes{0};
+std::atomic<std::ptrdiff_t> live_bytes{0};
+std::atomic<std::ptrdiff_t> peak_live_bytes{0};
+} // namespace
+
+// считаем все аллокации бинарника, размер блока храним перед ним
+void* operator new(std::size_t size) {
+	auto* block = static_cast<std::max_align_t*>(std::malloc(size + sizeof(std::max_align_t)));
+	if (block == nullptr) {
+		throw std::bad_alloc();
+	}
+	*reinterpret_cast<std::size_t*>(block) = size;
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+	auto live = live_bytes.fetch_add(static_cast<std::ptrdiff_t>(size), std::memory_order_relaxed) + static_cast<std::ptrdiff_t>(size);
+	auto peak = peak_live_bytes.load(std::memory_order_relaxed);
+	while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+	}
+	return block + 1;
+}
+void operator delete(void* ptr) noexcept {
+	if (ptr == nullptr) {
+		return;
+	}
+	auto* block = static_cast<std::max_align_t*>(ptr) - 1;
+	live_bytes.fetch_sub(static_cast<std::ptrdiff_t>(*reinterpret_cast<std::size_t*>(block)), std::memory_order_relaxed);
+	std::free(block);
+}
+void operator delete(void* ptr, std::size_t /*size*/) noexcept { operator delete(ptr); }
+
+namespace bench {
+MemoryStats memory_stats() {
+	return {allocations.load(), allocated_bytes.load(), live_bytes.load(), peak_live_bytes.load()};
+}
+void reset_peak_live_bytes() { peak_live_bytes.store(live_bytes.load()); }
+std::size_t peak_rss() {
+#ifdef LIBTECH_BENCH_RUSAGE
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+	return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+	return 0;
+#endif
+}
+} // namespace bench
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+// счетчики глобальных operator new/delete бинарника бенчмарков
+namespace bench {
+struct MemoryStats {
+	std::size_t allocations;
+	std::size_t allocated_bytes;
+	std::ptrdiff_t live_bytes;
+	std::ptrdiff_t peak_live_bytes;
+};
+MemoryStats memory_stats();
+// пик живой кучи отсчитывается заново от текущего значения
+void reset_peak_live_bytes();
+// пиковый RSS процесса в байтах, 0 если платформа не умеет
+std::size_t peak_rss();
+} // namespace bench
@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <libtech/hashmap.hpp>
+#include <libtech/incremental_hashmap.hpp>
+#include <random>
+#include <vector>
+
+// задержка отдельной вставки при росте с нуля: rehash целиком против постепенного.
+// Среднее почти одинаковое, разница в хвосте - вставке, на которую пришелся rehash
+namespace {
+template <class Map> void BM_InsertLatency(benchmark::State& state) {
+	const auto size = static_cast<std::size_t>(state.range(0));
+	std::mt19937_64 gen(1);
+	std::vector<std::uint64_t> keys(size);
+	for (auto& key : keys) {
+		key = gen();
+	}
+	std::vector<double> latencies(size);
+	for (auto _ : state) {
+		Map map;
+		for (std::size_t i = 0; i < size; ++i) {
+			auto start = std::chrono::steady_clock::now();
+			map.emplace(keys[i], i);
+			auto stop = std::chrono::steady_clock::now();
+			latencies[i] = std::chrono::duration<double, std::nano>(stop - start).count();
+		}
+		benchmark::DoNotOptimize(map.size());
+		state.PauseTiming();
+		map = Map();
+		state.ResumeTiming();
+	}
+	// перцентили последнего прогона, в наносекундах
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&](double p) { return latencies[static_cast<std::size_t>(p * static_cast<double>(size - 1))]; };
+	state.counters["p50_ns"] = percentile(0.5);
+	state.counters["p99_ns"] = percentile(0.99);
+	state.counters["p999_ns"] = percentile(0.999);
+	state.counters["p99999_ns"] = percentile(0.99999);
+	state.counters["max_ns"] = latencies.back();
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_InsertLatency, tech::HashMap<std::uint64_t, std::uint64_t>)
+	->RangeMultiplier(10)->Range(100'000, 10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_InsertLatency, tech::IncrementalHashMap<std::uint64_t, std::uint64_t>)
+	->RangeMultiplier(10)->Range(100'000, 10'000'000)->Unit(benchmark::kMillisecond);
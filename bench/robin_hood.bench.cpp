@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <libtech/hashmap.hpp>
+#include <libtech/robin_hood_map.hpp>
+#include <random>
+#include <vector>
+
+// поиск при заданном заполнении: Robin Hood против цепочек tech::HashMap.
+// range(0) - заполнение в процентах, ведер у обеих карт около BUCKETS
+namespace {
+constexpr std::size_t BUCKETS = 1 << 20;
+constexpr std::size_t LOOKUPS = 1 << 16;
+
+std::vector<std::uint64_t> random_keys(std::size_t count, std::uint64_t seed) {
+	std::mt19937_64 gen(seed);
+	std::vector<std::uint64_t> keys(count);
+	for (auto& key : keys) {
+		key = gen();
+	}
+	return keys;
+}
+
+// таблица растягивается заранее, потом заполняется ровно до нужной доли
+template <class Map> Map filled_map(const std::vector<std::uint64_t>& keys) {
+	Map map;
+	map.max_load_factor(0.95F);
+	map.rehash(BUCKETS);
+	for (auto key : keys) {
+		map.emplace(key, key);
+	}
+	return map;
+}
+
+template <class Map> void BM_LoadFactorHit(benchmark::State& state) {
+	auto keys = random_keys(BUCKETS * static_cast<std::size_t>(state.range(0)) / 100, 1);
+	auto map = filled_map<Map>(keys);
+	std::vector<std::uint64_t> lookups(LOOKUPS);
+	std::mt19937_64 gen(2);
+	for (auto& key : lookups) {
+		key = keys[gen() % keys.size()];
+	}
+	for (auto _ : state) {
+		std::uint64_t sum = 0;
+		for (auto key : lookups) {
+			sum += map.find(key)->second;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * LOOKUPS);
+	state.counters["load_factor"] = map.load_factor();
+	if constexpr (requires { map.max_probe_length(); }) {
+		state.counters["max_probe"] = static_cast<double>(map.max_probe_length());
+		state.counters["avg_probe"] = map.average_probe_length();
+	}
+}
+
+// промах: здесь Robin Hood обрывает пробу раньше, чем простое линейное пробирование
+template <class Map> void BM_LoadFactorMiss(benchmark::State& state) {
+	auto keys = random_keys(BUCKETS * static_cast<std::size_t>(state.range(0)) / 100, 1);
+	auto map = filled_map<Map>(keys);
+	auto lookups = random_keys(LOOKUPS, 3);
+	for (auto _ : state) {
+		std::size_t found = 0;
+		for (auto key : lookups) {
+			found += map.contains(key) ? 1 : 0;
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations() * LOOKUPS);
+	state.counters["load_factor"] = map.load_factor();
+}
+
+using RobinHood = tech::RobinHoodMap<std::uint64_t, std::uint64_t>;
+using Chaining = tech::HashMap<std::uint64_t, std::uint64_t>;
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_LoadFactorHit, RobinHood)->Arg(50)->Arg(75)->Arg(90)->Arg(95);
+BENCHMARK_TEMPLATE(BM_LoadFactorHit, Chaining)->Arg(50)->Arg(75)->Arg(90)->Arg(95);
+BENCHMARK_TEMPLATE(BM_LoadFactorMiss, RobinHood)->Arg(50)->Arg(75)->Arg(90)->Arg(95);
+BENCHMARK_TEMPLATE(BM_LoadFactorMiss, Chaining)->Arg(50)->Arg(75)->Arg(90)->Arg(95);
@@ -0,0 +1,167 @@
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <libtech/hashmap.hpp>
+#include <libtech/static_map.hpp>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// таблицы, известные при сборке: код операции -> обработчик и имя заголовка -> номер.
+// Совершенный хеш против tech::HashMap, собранной в рантайме, и ручного switch
+namespace {
+constexpr std::size_t LOOKUPS = 1 << 12;
+
+// коды разрежены, switch не сводится к одной таблице переходов
+constexpr std::array<std::pair<std::uint32_t, int>, 16> OPCODES{{{0x01, 1},
+																 {0x07, 2},
+																 {0x12, 3},
+																 {0x1F, 4},
+																 {0x40, 5},
+																 {0x41, 6},
+																 {0x88, 7},
+																 {0x9A, 8},
+																 {0x100, 9},
+																 {0x205, 10},
+																 {0x3E8, 11},
+																 {0x1000, 12},
+																 {0x1F40, 13},
+																 {0x8001, 14},
+																 {0xC350, 15},
+																 {0xFFFF, 16}}};
+constexpr auto OPCODE_MAP = tech::make_static_map(OPCODES);
+
+int opcode_switch(std::uint32_t opcode) {
+	switch (opcode) {
+	case 0x01: return 1;
+	case 0x07: return 2;
+	case 0x12: return 3;
+	case 0x1F: return 4;
+	case 0x40: return 5;
+	case 0x41: return 6;
+	case 0x88: return 7;
+	case 0x9A: return 8;
+	case 0x100: return 9;
+	case 0x205: return 10;
+	case 0x3E8: return 11;
+	case 0x1000: return 12;
+	case 0x1F40: return 13;
+	case 0x8001: return 14;
+	case 0xC350: return 15;
+	case 0xFFFF: return 16;
+	default: return 0;
+	}
+}
+
+std::vector<std::uint32_t> opcode_stream() {
+	std::mt19937 gen(1);
+	std::vector<std::uint32_t> stream(LOOKUPS);
+	for (auto& opcode : stream) {
+		opcode = OPCODES[gen() % OPCODES.size()].first;
+	}
+	return stream;
+}
+
+template <class Lookup> void run_opcodes(benchmark::State& state, Lookup lookup) {
+	auto stream = opcode_stream();
+	for (auto _ : state) {
+		int sum = 0;
+		for (auto opcode : stream) {
+			sum += lookup(opcode);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * LOOKUPS);
+}
+
+void BM_OpcodeStaticMap(benchmark::State& state) {
+	run_opcodes(state, [](std::uint32_t opcode) {
+		auto it = OPCODE_MAP.find(opcode);
+		return it != OPCODE_MAP.end() ? it->second : 0;
+	});
+}
+void BM_OpcodeHashMap(benchmark::State& state) {
+	tech::HashMap<std::uint32_t, int> map(OPCODES.begin(), OPCODES.end());
+	run_opcodes(state, [&](std::uint32_t opcode) {
+		auto it = map.find(opcode);
+		return it != map.end() ? it->second : 0;
+	});
+}
+void BM_OpcodeSwitch(benchmark::State& state) { run_opcodes(state, opcode_switch); }
+
+constexpr std::array<std::pair<std::string_view, int>, 20> HEADERS{{{"accept", 1},
+																	{"accept-encoding", 2},
+																	{"accept-language", 3},
+																	{"authorization", 4},
+																	{"cache-control", 5},
+																	{"connection", 6},
+																	{"content-length", 7},
+																	{"content-type", 8},
+																	{"cookie", 9},
+																	{"date", 10},
+																	{"etag", 11},
+																	{"host", 12},
+																	{"if-none-match", 13},
+																	{"location", 14},
+																	{"origin", 15},
+																	{"referer", 16},
+																	{"server", 17},
+																	{"set-cookie", 18},
+																	{"transfer-encoding", 19},
+																	{"user-agent", 20}}};
+constexpr auto HEADER_MAP = tech::make_static_map(HEADERS);
+
+// строки в switch не идут, ручной разбор - цепочка сравнений
+int header_chain(std::string_view name) {
+	for (const auto& [header, id] : HEADERS) {
+		if (header == name) {
+			return id;
+		}
+	}
+	return 0;
+}
+
+std::vector<std::string_view> header_stream() {
+	std::mt19937 gen(1);
+	std::vector<std::string_view> stream(LOOKUPS);
+	for (auto& name : stream) {
+		name = HEADERS[gen() % HEADERS.size()].first;
+	}
+	return stream;
+}
+
+template <class Lookup> void run_headers(benchmark::State& state, Lookup lookup) {
+	auto stream = header_stream();
+	for (auto _ : state) {
+		int sum = 0;
+		for (auto name : stream) {
+			sum += lookup(name);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * LOOKUPS);
+}
+
+void BM_HeaderStaticMap(benchmark::State& state) {
+	run_headers(state, [](std::string_view name) {
+		auto it = HEADER_MAP.find(name);
+		return it != HEADER_MAP.end() ? it->second : 0;
+	});
+}
+void BM_HeaderHashMap(benchmark::State& state) {
+	tech::HashMap<std::string_view, int> map(HEADERS.begin(), HEADERS.end());
+	run_headers(state, [&](std::string_view name) {
+		auto it = map.find(name);
+		return it != map.end() ? it->second : 0;
+	});
+}
+void BM_HeaderCompareChain(benchmark::State& state) { run_headers(state, header_chain); }
+} // namespace
+
+BENCHMARK(BM_OpcodeStaticMap);
+BENCHMARK(BM_OpcodeHashMap);
+BENCHMARK(BM_OpcodeSwitch);
+BENCHMARK(BM_HeaderStaticMap);
+BENCHMARK(BM_HeaderHashMap);
+BENCHMARK(BM_HeaderCompareChain);
@@ -0,0 +1,238 @@
+#include "memory_stats.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <libtech/flat_hashmap.hpp>
+#include <libtech/hashmap.hpp>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// общий набор: каждая операция на каждой карте и каждом типе ключа, рядом с std::unordered_map.
+// Счетчики: time/op, allocs/op, peak_heap (пик живой кучи за прогон) и peak_rss процесса
+namespace {
+
+/* ключи */
+struct IntKey {
+	using type = std::uint64_t;
+	static type make(std::uint64_t value) { return value; }
+};
+// строка фиксированной длины, у 16 байт уже нет SSO, у 64 сравнение заметно
+template <std::size_t Length> struct StringKey {
+	using type = std::string;
+	static type make(std::uint64_t value) {
+		static constexpr char DIGITS[] = "0123456789abcdef";
+		std::string result(Length, '0');
+		for (std::size_t i = 0; i < Length && value != 0; ++i, value >>= 4) {
+			result[Length - 1 - i] = DIGITS[value & 0xF];
+		}
+		return result;
+	}
+};
+using String16 = StringKey<16>;
+using String64 = StringKey<64>;
+
+/* карты */
+struct ChainedMap {
+	template <class Key> using map = tech::HashMap<Key, std::uint64_t>;
+};
+struct FlatMap {
+	template <class Key> using map = tech::FlatHashMap<Key, std::uint64_t>;
+};
+struct StdMap {
+	template <class Key> using map = std::unordered_map<Key, std::uint64_t>;
+};
+
+template <class KeyKind> std::vector<typename KeyKind::type> make_keys(std::size_t count, std::uint64_t seed) {
+	std::mt19937_64 gen(seed);
+	std::vector<typename KeyKind::type> keys;
+	keys.reserve(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		keys.push_back(KeyKind::make(gen()));
+	}
+	return keys;
+}
+
+template <class Map, class Keys> Map make_map(const Keys& keys) {
+	Map map;
+	map.reserve(keys.size());
+	for (const auto& key : keys) {
+		map.emplace(key, 1);
+	}
+	return map;
+}
+
+// снимает память в начале прогона и пишет счетчики в конце,
+// аллокации на паузе (подготовка карты) в allocs/op не попадают
+class Report {
+  public:
+	explicit Report(benchmark::State& bench_state) : state(bench_state) {
+		bench::reset_peak_live_bytes();
+		before = bench::memory_stats();
+	}
+	void pause() {
+		state.PauseTiming();
+		paused_at = bench::memory_stats().allocations;
+	}
+	void resume() {
+		excluded += bench::memory_stats().allocations - paused_at;
+		state.ResumeTiming();
+	}
+	void finish(std::int64_t ops_per_iteration) {
+		auto after = bench::memory_stats();
+		auto ops = static_cast<double>(state.iterations() * ops_per_iteration);
+		state.counters["time/op"] = benchmark::Counter(ops, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+		state.counters["allocs/op"] = static_cast<double>(after.allocations - before.allocations - excluded) / ops;
+		state.counters["peak_heap"] = benchmark::Counter(static_cast<double>(after.peak_live_bytes), benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+		state.counters["peak_rss"] = benchmark::Counter(static_cast<double>(bench::peak_rss()), benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+	}
+
+  private:
+	benchmark::State& state;
+	bench::MemoryStats before{};
+	std::size_t paused_at = 0;
+	std::size_t excluded = 0;
+};
+
+/* операции */
+template <class Family, class KeyKind> void BM_SuiteInsert(benchmark::State& state) {
+	using Map = typename Family::template map<typename KeyKind::type>;
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto keys = make_keys<KeyKind>(size, 1);
+	Report report(state);
+	for (auto _ : state) {
+		Map map;
+		for (const auto& key : keys) {
+			map.emplace(key, 1);
+		}
+		benchmark::DoNotOptimize(map.size());
+		report.pause();
+		map = Map();
+		report.resume();
+	}
+	report.finish(static_cast<std::int64_t>(size));
+}
+
+template <class Family, class KeyKind> void BM_SuiteFindHit(benchmark::State& state) {
+	using Map = typename Family::template map<typename KeyKind::type>;
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto keys = make_keys<KeyKind>(size, 1);
+	auto map = make_map<Map>(keys);
+	std::shuffle(keys.begin(), keys.end(), std::mt19937_64(2));
+	std::size_t i = 0;
+	Report report(state);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(map.find(keys[i]));
+		if (++i == size) {
+			i = 0;
+		}
+	}
+	report.finish(1);
+}
+
+template <class Family, class KeyKind> void BM_SuiteFindMiss(benchmark::State& state) {
+	using Map = typename Family::template map<typename KeyKind::type>;
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto map = make_map<Map>(make_keys<KeyKind>(size, 1));
+	auto missing = make_keys<KeyKind>(size, 3);
+	std::size_t i = 0;
+	Report report(state);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(map.find(missing[i]));
+		if (++i == size) {
+			i = 0;
+		}
+	}
+	report.finish(1);
+}
+
+template <class Family, class KeyKind> void BM_SuiteErase(benchmark::State& state) {
+	using Map = typename Family::template map<typename KeyKind::type>;
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto keys = make_keys<KeyKind>(size, 1);
+	auto order = keys;
+	std::shuffle(order.begin(), order.end(), std::mt19937_64(2));
+	Report report(state);
+	for (auto _ : state) {
+		report.pause();
+		auto map = make_map<Map>(keys);
+		report.resume();
+		for (const auto& key : order) {
+			map.erase(key);
+		}
+		benchmark::DoNotOptimize(map.size());
+	}
+	report.finish(static_cast<std::int64_t>(size));
+}
+
+template <class Family, class KeyKind> void BM_SuiteIterate(benchmark::State& state) {
+	using Map = typename Family::template map<typename KeyKind::type>;
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto map = make_map<Map>(make_keys<KeyKind>(size, 1));
+	Report report(state);
+	for (auto _ : state) {
+		std::uint64_t sum = 0;
+		for (const auto& value : map) {
+			sum += value.second;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	report.finish(static_cast<std::int64_t>(size));
+}
+
+// чередуем два размера таблицы, чтобы каждый прогон перевешивал все элементы
+template <class Family, class KeyKind> void BM_SuiteRehash(benchmark::State& state) {
+	using Map = typename Family::template map<typename KeyKind::type>;
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto map = make_map<Map>(make_keys<KeyKind>(size, 1));
+	const auto small = map.bucket_count();
+	bool grow = true;
+	Report report(state);
+	for (auto _ : state) {
+		map.rehash(grow ? small * 4 : small);
+		grow = !grow;
+		benchmark::DoNotOptimize(map.bucket_count());
+	}
+	report.finish(static_cast<std::int64_t>(size));
+}
+
+template <class Family, class KeyKind> void BM_SuiteSubscript(benchmark::State& state) {
+	using Map = typename Family::template map<typename KeyKind::type>;
+	const auto size = static_cast<std::size_t>(state.range(0));
+	auto keys = make_keys<KeyKind>(size, 1);
+	auto map = make_map<Map>(keys);
+	std::shuffle(keys.begin(), keys.end(), std::mt19937_64(2));
+	std::size_t i = 0;
+	Report report(state);
+	for (auto _ : state) {
+		++map[keys[i]];
+		if (++i == size) {
+			i = 0;
+		}
+	}
+	report.finish(1);
+}
+
+void suite_sizes(benchmark::internal::Benchmark* bench) {
+	bench->RangeMultiplier(10)->Range(1'000, 10'000'000);
+}
+} // namespace
+
+#define SUITE_FOR_KEYS(op, Family)                                                                                     \
+	BENCHMARK_TEMPLATE(op, Family, IntKey)->Apply(suite_sizes);                                                        \
+	BENCHMARK_TEMPLATE(op, Family, String16)->Apply(suite_sizes);                                                      \
+	BENCHMARK_TEMPLATE(op, Family, String64)->Apply(suite_sizes)
+#define SUITE(op)                                                                                                      \
+	SUITE_FOR_KEYS(op, ChainedMap);                                                                                    \
+	SUITE_FOR_KEYS(op, FlatMap);                                                                                       \
+	SUITE_FOR_KEYS(op, StdMap)
+
+SUITE(BM_SuiteInsert);
+SUITE(BM_SuiteFindHit);
+SUITE(BM_SuiteFindMiss);
+SUITE(BM_SuiteErase);
+SUITE(BM_SuiteIterate);
+SUITE(BM_SuiteRehash);
+SUITE(BM_SuiteSubscript);
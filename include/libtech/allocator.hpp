@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace tech {
+// пул блоков фиксированного размера: под каждый размер свой список свободных
+// блоков, блоки нарезаются из больших чанков и возвращаются только в release()
+class PoolResource {
+  public:
+	static constexpr std::size_t ALIGNMENT = alignof(std::max_align_t);
+	static constexpr std::size_t MAX_SIZE_CLASSES = 8;
+
+	explicit PoolResource(std::size_t chunk_blocks = 256) : blocks_per_chunk(std::max<std::size_t>(chunk_blocks, 1)) {}
+	PoolResource(const PoolResource&) = delete;
+	PoolResource& operator=(const PoolResource&) = delete;
+	~PoolResource() { release(); }
+
+	void* allocate(std::size_t size, std::size_t alignment) {
+		// блоки пула выровнены только по ALIGNMENT, класс размера под такой запрос не заводится
+		if (alignment > ALIGNMENT) {
+			return ::operator new(size, std::align_val_t{alignment});
+		}
+		auto* size_class = find_class(block_size_for(size));
+		if (size_class == nullptr) {
+			return ::operator new(size);
+		}
+		if (size_class->free == nullptr) {
+			refill(*size_class);
+		}
+		auto* block = size_class->free;
+		size_class->free = block->next;
+		return block;
+	}
+	void deallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept {
+		if (alignment > ALIGNMENT) {
+			::operator delete(ptr, std::align_val_t{alignment});
+			return;
+		}
+		auto* size_class = find_class(block_size_for(size));
+		if (size_class == nullptr) {
+			::operator delete(ptr);
+			return;
+		}
+		auto* block = static_cast<FreeBlock*>(ptr);
+		block->next = size_class->free;
+		size_class->free = block;
+	}
+	// отдает все чанки разом, выделенные из пула блоки становятся невалидными
+	void release() noexcept {
+		while (chunks) {
+			auto* next = chunks->next;
+			::operator delete(chunks);
+			chunks = next;
+		}
+		for (std::size_t i = 0; i < class_count; ++i) {
+			classes[i].free = nullptr;
+		}
+	}
+	// заведенных классов размера, не больше MAX_SIZE_CLASSES
+	std::size_t size_class_count() const noexcept { return class_count; }
+
+  private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+	struct alignas(ALIGNMENT) Chunk {
+		Chunk* next;
+	};
+	struct SizeClass {
+		std::size_t block_size = 0;
+		FreeBlock* free = nullptr;
+	};
+	std::array<SizeClass, MAX_SIZE_CLASSES> classes{};
+	std::size_t class_count = 0;
+	Chunk* chunks = nullptr;
+	std::size_t blocks_per_chunk;
+
+	static constexpr std::size_t block_size_for(std::size_t size) {
+		size = std::max(size, sizeof(FreeBlock));
+		return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	}
+	SizeClass* find_class(std::size_t block_size) noexcept {
+		for (std::size_t i = 0; i < class_count; ++i) {
+			if (classes[i].block_size == block_size) {
+				return &classes[i];
+			}
+		}
+		if (class_count == MAX_SIZE_CLASSES) {
+			return nullptr;
+		}
+		classes[class_count].block_size = block_size;
+		return &classes[class_count++];
+	}
+	void refill(SizeClass& size_class) {
+		auto* chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + size_class.block_size * blocks_per_chunk));
+		chunk->next = chunks;
+		chunks = chunk;
+		auto* data = reinterpret_cast<std::byte*>(chunk + 1);
+		for (std::size_t i = blocks_per_chunk; i-- > 0;) {
+			auto* block = reinterpret_cast<FreeBlock*>(data + i * size_class.block_size);
+			block->next = size_class.free;
+			size_class.free = block;
+		}
+	}
+};
+
+// пул общий для всех копий и rebind'ов аллокатора, массивы (n != 1) идут мимо пула
+template <class T> class PoolAllocator {
+  public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	PoolAllocator() : pool(std::make_shared<PoolResource>()) {}
+	explicit PoolAllocator(std::shared_ptr<PoolResource> resource) noexcept : pool(std::move(resource)) {}
+	// перемещение копирует: источник обязан остаться равным себе, контейнер после move им еще пользуется
+	PoolAllocator(const PoolAllocator&) noexcept = default;
+	PoolAllocator& operator=(const PoolAllocator&) noexcept = default;
+	template <class U> PoolAllocator(const PoolAllocator<U>& other) noexcept : pool(other.resource()) {}
+
+	T* allocate(std::size_t n) {
+		if (n == 1) {
+			return static_cast<T*>(pool->allocate(sizeof(T), alignof(T)));
+		}
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T* ptr, std::size_t n) noexcept {
+		if (n == 1) {
+			pool->deallocate(ptr, sizeof(T), alignof(T));
+		} else {
+			std::allocator<T>().deallocate(ptr, n);
+		}
+	}
+	const std::shared_ptr<PoolResource>& resource() const noexcept { return pool; }
+	template <class U> bool operator==(const PoolAllocator<U>& other) const noexcept {
+		return pool == other.resource();
+	}
+
+  private:
+	std::shared_ptr<PoolResource> pool;
+};
+
+// монотонная арена: память только выдается, освобождается вся сразу в release()
+class Arena {
+  public:
+	explicit Arena(std::size_t first_block_size = 64 * 1024) : next_block_size(std::max<std::size_t>(first_block_size, 64)) {}
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+	~Arena() { release(); }
+
+	void* allocate(std::size_t size, std::size_t alignment) {
+		void* ptr = current;
+		std::size_t space = static_cast<std::size_t>(end - current);
+		if (current == nullptr || std::align(alignment, size, ptr, space) == nullptr) {
+			grow(size + alignment);
+			ptr = current;
+			space = static_cast<std::size_t>(end - current);
+			std::align(alignment, size, ptr, space);
+		}
+		current = static_cast<std::byte*>(ptr) + size;
+		used += size;
+		return ptr;
+	}
+	void release() noexcept {
+		while (blocks) {
+			auto* next = blocks->next;
+			::operator delete(blocks);
+			blocks = next;
+		}
+		current = nullptr;
+		end = nullptr;
+		used = 0;
+	}
+	std::size_t bytes_allocated() const noexcept { return used; }
+
+  private:
+	struct alignas(std::max_align_t) Block {
+		Block* next;
+	};
+	Block* blocks = nullptr;
+	std::byte* current = nullptr;
+	std::byte* end = nullptr;
+	std::size_t next_block_size;
+	std::size_t used = 0;
+
+	void grow(std::size_t min_size) {
+		auto size = std::max(next_block_size, min_size);
+		auto* block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+		block->next = blocks;
+		blocks = block;
+		current = reinterpret_cast<std::byte*>(block + 1);
+		end = current + size;
+		next_block_size = size * 2;
+	}
+};
+
+template <class T> class ArenaAllocator {
+  public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	explicit ArenaAllocator(Arena& resource) noexcept : arena(&resource) {}
+	template <class U> ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.resource()) {}
+
+	T* allocate(std::size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T* /*ptr*/, std::size_t /*n*/) noexcept {}
+	Arena* resource() const noexcept { return arena; }
+	template <class U> bool operator==(const ArenaAllocator<U>& other) const noexcept {
+		return arena == other.resource();
+	}
+
+  private:
+	Arena* arena;
+};
+} // namespace tech
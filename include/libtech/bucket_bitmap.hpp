@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <libtech/vector.hpp>
+#include <memory>
+#include <utility>
+
+namespace tech {
+namespace detail {
+// бит на ведро: занято или пусто. Следующее непустое ведро ищется по словам
+// через countr_zero, так что пустые ведра пропускаются по 64 за шаг
+template <class Allocator> class BucketBitmap {
+  public:
+	using size_type = std::size_t;
+	using word_type = std::uint64_t;
+	static constexpr const size_type WORD_BITS = 64;
+
+	explicit BucketBitmap(const Allocator& allocator) : alloc(allocator), words(alloc) {}
+	BucketBitmap(const BucketBitmap&) = default;
+	// аллокатор копируется, а не перемещается: перемещенный битмап еще нужно уметь reset()
+	BucketBitmap(BucketBitmap&& other) noexcept
+		: alloc(other.alloc), words(std::move(other.words)), bits(std::exchange(other.bits, 0)) {}
+	// alloc следует за words: следующий reset() выделяет тем же аллокатором, что и контейнеры
+	BucketBitmap& operator=(const BucketBitmap& other) {
+		if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+			alloc = other.alloc;
+		}
+		words = other.words;
+		bits = other.bits;
+		return *this;
+	}
+	BucketBitmap& operator=(BucketBitmap&& other) noexcept {
+		if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+			alloc = other.alloc;
+		}
+		words = std::move(other.words);
+		bits = std::exchange(other.bits, 0);
+		return *this;
+	}
+	~BucketBitmap() = default;
+
+	// count битов, все сброшены
+	void reset(size_type count) {
+		auto words_count = (count + WORD_BITS - 1) / WORD_BITS;
+		words = words_type(words_count, alloc);
+		words.resize(words_count);
+		std::fill_n(words.data(), words_count, word_type(0));
+		bits = count;
+	}
+	size_type size() const noexcept { return bits; }
+	bool test(size_type i) const { return (words[i / WORD_BITS] >> (i % WORD_BITS)) & 1; }
+	void set(size_type i) { words[i / WORD_BITS] |= word_type(1) << (i % WORD_BITS); }
+	void clear(size_type i) { words[i / WORD_BITS] &= ~(word_type(1) << (i % WORD_BITS)); }
+	// все биты сброшены, размер тот же
+	void clear_all() noexcept { std::fill_n(words.data(), words.size(), word_type(0)); }
+	// первый установленный бит не раньше from, size() если таких нет
+	size_type find_next(size_type from) const {
+		if (from >= bits) {
+			return bits;
+		}
+		auto w = from / WORD_BITS;
+		auto word = words[w] & (~word_type(0) << (from % WORD_BITS));
+		while (word == 0) {
+			if (++w == words.size()) {
+				return bits;
+			}
+			word = words[w];
+		}
+		return w * WORD_BITS + std::countr_zero(word);
+	}
+
+  private:
+	using word_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<word_type>;
+	using alloc_traits = std::allocator_traits<word_allocator>;
+	using words_type = Vector<word_type, word_allocator>;
+	[[no_unique_address]] word_allocator alloc;
+	words_type words;
+	size_type bits = 0;
+};
+} // namespace detail
+} // namespace tech
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <libtech/hashmap.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+
+namespace tech {
+// карта из независимых шардов: у каждого свой HashMap и свой shared_mutex,
+// шард выбирается по старшим битам хеша, так что потоки с разными ключами
+// почти не встречаются на одной блокировке.
+// Итераторов нет: наружу нельзя отдать ссылку, которую держит только замок шарда
+template <class Key, class T, class Hash = tech::Hash<Key>, class KeyEqual = std::equal_to<Key>,
+		  class Allocator = std::allocator<std::pair<Key, T>>>
+class ConcurrentHashMap {
+  public:
+	using size_type = std::size_t;
+	using value_type = std::pair<Key, T>;
+	using key_type = Key;
+	using mapped_type = T;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using allocator_type = Allocator;
+	using map_type = HashMap<Key, T, Hash, KeyEqual, Allocator>;
+
+	static constexpr const size_type DEFAULT_SHARD_COUNT = 64;
+
+  private:
+	// шарды на разных кеш-линиях, иначе соседние мьютексы мешают друг другу
+	static constexpr const std::size_t CACHE_LINE = 64;
+	struct alignas(CACHE_LINE) Shard {
+		Shard(size_type buckets_count, const Hash& hash, const KeyEqual& equal, const Allocator& alloc)
+			: map(buckets_count, hash, equal, alloc) {}
+		mutable std::shared_mutex mutex;
+		map_type map;
+	};
+	// мьютекс не перемещается, поэтому шарды строятся сразу на месте
+	struct ShardDeleter {
+		size_type count = 0;
+		void operator()(Shard* ptr) const noexcept {
+			std::destroy_n(ptr, count);
+			std::allocator<Shard>().deallocate(ptr, count);
+		}
+	};
+	std::unique_ptr<Shard[], ShardDeleter> shards;
+	size_type shards_count;
+	int shard_shift;
+	Hash hash;
+	[[no_unique_address]] KeyEqual equal;
+
+  public:
+	/* constructors */
+	explicit ConcurrentHashMap(size_type shard_count = DEFAULT_SHARD_COUNT, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: ConcurrentHashMap(shard_count, 0, _hash, _equal, alloc) {}
+	// buckets_count - на всю карту, шарды делят его поровну. Карты шардов получают
+	// те же hash, equal и аллокатор, что и сама карта
+	ConcurrentHashMap(size_type shard_count, size_type buckets_count, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: shards_count(std::bit_ceil(std::max<size_type>(shard_count, 1))),
+		  shard_shift(64 - std::countr_zero(shards_count)), hash(_hash), equal(_equal) {
+		auto* data = std::allocator<Shard>().allocate(shards_count);
+		size_type built = 0;
+		try {
+			for (; built < shards_count; ++built) {
+				std::construct_at(data + built, buckets_count / shards_count + 1, hash, equal, alloc);
+			}
+		} catch (...) {
+			ShardDeleter{built}(data);
+			throw;
+		}
+		shards = std::unique_ptr<Shard[], ShardDeleter>(data, ShardDeleter{shards_count});
+	}
+	ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+	ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+	/* capacity */
+	// сумма по шардам, при параллельных вставках это лишь оценка
+	size_type size() const {
+		size_type result = 0;
+		for (size_type i = 0; i < shards_count; ++i) {
+			std::shared_lock lock(shards[i].mutex);
+			result += shards[i].map.size();
+		}
+		return result;
+	}
+	bool empty() const { return size() == 0; }
+	size_type shard_count() const noexcept { return shards_count; }
+
+	/* modifiers */
+	void clear() {
+		for (size_type i = 0; i < shards_count; ++i) {
+			std::unique_lock lock(shards[i].mutex);
+			shards[i].map.clear();
+		}
+	}
+	void reserve(size_type count) {
+		for (size_type i = 0; i < shards_count; ++i) {
+			std::unique_lock lock(shards[i].mutex);
+			shards[i].map.reserve(count / shards_count + 1);
+		}
+	}
+	bool insert(const value_type& value) { return emplace(value.first, value.second); }
+	bool insert(value_type&& value) { return emplace(std::move(value.first), std::move(value.second)); }
+	template <class K, class... Args>
+	bool emplace(K&& key, Args&&... args) {
+		auto& shard = shard_for(key);
+		std::unique_lock lock(shard.mutex);
+		return shard.map.try_emplace(std::forward<K>(key), std::forward<Args>(args)...).second;
+	}
+	size_type erase(const Key& key) {
+		auto& shard = shard_for(key);
+		std::unique_lock lock(shard.mutex);
+		return shard.map.erase(key);
+	}
+	// если ключ есть, fn(T&) под эксклюзивной блокировкой шарда,
+	// если нет, вставляется T(args...). Возвращает true при вставке
+	template <class K, class F, class... Args>
+	bool upsert(K&& key, F&& fn, Args&&... args) {
+		auto& shard = shard_for(key);
+		std::unique_lock lock(shard.mutex);
+		auto [it, inserted] = shard.map.try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+		if (!inserted) {
+			std::invoke(std::forward<F>(fn), it->second);
+		}
+		return inserted;
+	}
+
+	/* lookup */
+	// копия значения: ссылка пережила бы блокировку
+	std::optional<T> find(const Key& key) const {
+		auto& shard = shard_for(key);
+		std::shared_lock lock(shard.mutex);
+		auto it = shard.map.find(key);
+		if (it == shard.map.end()) {
+			return std::nullopt;
+		}
+		return it->second;
+	}
+	// fn(const T&) под разделяемой блокировкой, без копирования значения
+	template <class F>
+	bool visit(const Key& key, F&& fn) const {
+		auto& shard = shard_for(key);
+		std::shared_lock lock(shard.mutex);
+		auto it = shard.map.find(key);
+		if (it == shard.map.end()) {
+			return false;
+		}
+		std::invoke(std::forward<F>(fn), std::as_const(it->second));
+		return true;
+	}
+	bool contains(const Key& key) const {
+		auto& shard = shard_for(key);
+		std::shared_lock lock(shard.mutex);
+		return shard.map.contains(key);
+	}
+	size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+	/* visitors */
+	// обход по шардам, каждый под своей блокировкой: снимок всей карты не атомарен
+	template <class F>
+	void for_each(F&& fn) const {
+		for (size_type i = 0; i < shards_count; ++i) {
+			std::shared_lock lock(shards[i].mutex);
+			for (const auto& value : shards[i].map) {
+				fn(value);
+			}
+		}
+	}
+	template <class F>
+	void for_each(F&& fn) {
+		for (size_type i = 0; i < shards_count; ++i) {
+			std::unique_lock lock(shards[i].mutex);
+			for (auto& value : shards[i].map) {
+				fn(value);
+			}
+		}
+	}
+
+	/* observers */
+	Hash hash_function() const { return hash; }
+	KeyEqual key_eq() const { return equal; }
+
+  private:
+	// старшие биты после умножения Фибоначчи: хеш внутри шарда берет младшие,
+	// а тождественный std::hash<int> без перемешивания сложил бы все в шард 0
+	template <class K>
+	Shard& shard_for(const K& key) const {
+		std::uint64_t h = static_cast<std::uint64_t>(hash(key)) * 0x9E3779B97F4A7C15ULL;
+		return shards[shard_shift == 64 ? 0 : h >> shard_shift];
+	}
+};
+} // namespace tech
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace tech {
+namespace detail {
+// запись потока в домене: эпоха, которую он видел при входе в чтение, 0 - вне чтения.
+// На своей кеш-линии, чтобы читатели разных потоков не писали в одну
+struct alignas(64) EpochRecord {
+	std::atomic<std::uint64_t> epoch{0};
+	std::atomic<bool> in_use{false};
+	EpochRecord* next = nullptr;
+	unsigned nesting = 0;
+};
+} // namespace detail
+
+// освобождение памяти по эпохам (EBR): читатель на время обхода закрепляет эпоху,
+// писатель помечает вынутый из структуры объект текущей эпохой и освобождает его,
+// когда глобальная эпоха ушла на две вперед - к этому моменту каждый, кто мог
+// видеть объект, из чтения уже вышел. Домен один на процесс, записи потоков переиспользуются
+class EpochDomain {
+  public:
+	// закрепление эпохи, вложенные закрепления одного потока дешевые
+	class Guard {
+	  public:
+		Guard(const Guard&) = delete;
+		Guard& operator=(const Guard&) = delete;
+		Guard(Guard&& other) noexcept : record(std::exchange(other.record, nullptr)) {}
+		Guard& operator=(Guard&&) = delete;
+		~Guard() {
+			if (record && --record->nesting == 0) {
+				record->epoch.store(0, std::memory_order_release);
+			}
+		}
+
+	  private:
+		friend class EpochDomain;
+		explicit Guard(detail::EpochRecord* _record) : record(_record) {}
+		detail::EpochRecord* record;
+	};
+
+	static EpochDomain& global() {
+		static EpochDomain domain;
+		return domain;
+	}
+	EpochDomain(const EpochDomain&) = delete;
+	EpochDomain& operator=(const EpochDomain&) = delete;
+
+	Guard pin() {
+		auto& record = local_record();
+		if (record.nesting++ == 0) {
+			// объявление эпохи видно раньше, чем любое чтение структуры. exchange, а не store с барьером:
+			// GCC делает барьер как lock or по стеку, и он тормозит соседние обращения к стеку
+			record.epoch.exchange(epoch.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+		}
+		return Guard(&record);
+	}
+	std::uint64_t current() const noexcept { return epoch.load(std::memory_order_seq_cst); }
+	// эпоха сдвигается, если каждый читающий поток уже видел текущую. Возвращает текущую после попытки
+	std::uint64_t try_advance() {
+		auto current_epoch = epoch.load(std::memory_order_seq_cst);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		for (auto* record = records.load(std::memory_order_acquire); record; record = record->next) {
+			auto seen = record->epoch.load(std::memory_order_seq_cst);
+			if (seen != 0 && seen != current_epoch) {
+				return current_epoch;
+			}
+		}
+		if (epoch.compare_exchange_strong(current_epoch, current_epoch + 1, std::memory_order_seq_cst)) {
+			return current_epoch + 1;
+		}
+		return current_epoch;
+	}
+	// объект, помеченный эпохой retired, больше никем не читается
+	static constexpr bool is_safe(std::uint64_t retired, std::uint64_t current_epoch) noexcept {
+		return retired + 2 <= current_epoch;
+	}
+
+  private:
+	EpochDomain() = default;
+
+	// запись берется при первом закреплении в потоке и освобождается при его завершении
+	struct RecordHolder {
+		detail::EpochRecord* record;
+		explicit RecordHolder(EpochDomain& domain) : record(domain.acquire_record()) {}
+		~RecordHolder() {
+			record->epoch.store(0, std::memory_order_release);
+			record->in_use.store(false, std::memory_order_release);
+		}
+	};
+	detail::EpochRecord& local_record() {
+		thread_local RecordHolder holder(*this);
+		return *holder.record;
+	}
+	// записи только добавляются в голову списка и не удаляются: обход без блокировок
+	detail::EpochRecord* acquire_record() {
+		for (auto* record = records.load(std::memory_order_acquire); record; record = record->next) {
+			bool expected = false;
+			if (!record->in_use.load(std::memory_order_relaxed) &&
+				record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+				return record;
+			}
+		}
+		auto* record = new detail::EpochRecord;
+		record->in_use.store(true, std::memory_order_relaxed);
+		record->next = records.load(std::memory_order_relaxed);
+		while (!records.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed)) {
+		}
+		return record;
+	}
+
+	std::atomic<std::uint64_t> epoch{1};
+	std::atomic<detail::EpochRecord*> records{nullptr};
+};
+} // namespace tech
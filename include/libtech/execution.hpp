@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace tech {
+// политики выполнения для массовых операций контейнеров. Интерфейс как у std::execution,
+// но потоки свои: <execution> из libstdc++ тянет TBB в линковку каждому, кто подключил заголовок
+namespace execution {
+struct sequenced_policy {};
+struct parallel_policy {
+	// 0 - по числу ядер
+	std::size_t threads = 0;
+};
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+
+template <class T> struct is_execution_policy : std::false_type {};
+template <> struct is_execution_policy<sequenced_policy> : std::true_type {};
+template <> struct is_execution_policy<parallel_policy> : std::true_type {};
+template <class T> inline constexpr bool is_execution_policy_v = is_execution_policy<std::remove_cvref_t<T>>::value;
+} // namespace execution
+
+// можно ли выделять ноды из нескольких потоков сразу. Свои аллокаторы
+// (пул, арена) состояние не защищают, для них вставка остается последовательной
+template <class Allocator> struct is_concurrent_allocator : std::false_type {};
+template <class T> struct is_concurrent_allocator<std::allocator<T>> : std::true_type {};
+
+namespace detail {
+// меньше элементов на поток не окупают его запуск
+inline constexpr const std::size_t MIN_ITEMS_PER_THREAD = 1 << 14;
+
+inline std::size_t parts_for(execution::sequenced_policy /*policy*/, std::size_t /*items*/) { return 1; }
+inline std::size_t parts_for(const execution::parallel_policy& policy, std::size_t items) {
+	std::size_t threads = policy.threads != 0 ? policy.threads : std::thread::hardware_concurrency();
+	return std::clamp<std::size_t>(items / MIN_ITEMS_PER_THREAD, 1, std::max<std::size_t>(threads, 1));
+}
+
+// fn(part, begin, end) на parts равных кусках [0, count), кусок 0 на текущем потоке.
+// Первое исключение пробрасывается после того, как все потоки закончили
+template <class F> void run_parts(std::size_t parts, std::size_t count, F&& fn) {
+	std::vector<std::exception_ptr> errors(parts);
+	auto job = [&](std::size_t part) {
+		try {
+			fn(part, count * part / parts, count * (part + 1) / parts);
+		} catch (...) {
+			errors[part] = std::current_exception();
+		}
+	};
+	std::vector<std::thread> threads;
+	threads.reserve(parts - 1);
+	try {
+		for (std::size_t part = 1; part < parts; ++part) {
+			threads.emplace_back(job, part);
+		}
+	} catch (...) {
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		throw;
+	}
+	job(0);
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	for (auto& error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+// fn(part, begin, end) на кусках [0, count) по chunk штук, parts потоков разбирают куски
+// через общий счетчик: поток с тяжелыми кусками просто берет их меньше, остальные доделывают.
+// После исключения новые куски не выдаются, оно пробрасывается как в run_parts
+template <class F> void run_chunks(std::size_t parts, std::size_t count, std::size_t chunk, F&& fn) {
+	std::atomic<std::size_t> next{0};
+	run_parts(parts, parts, [&](std::size_t part, std::size_t /*begin*/, std::size_t /*end*/) {
+		for (auto begin = next.fetch_add(chunk, std::memory_order_relaxed); begin < count;
+			 begin = next.fetch_add(chunk, std::memory_order_relaxed)) {
+			try {
+				fn(part, begin, std::min(begin + chunk, count));
+			} catch (...) {
+				next.store(count, std::memory_order_relaxed);
+				throw;
+			}
+		}
+	});
+}
+// для fn, которая не бросает: куски, под которые не удалось запустить поток, выполняются
+// на текущем. Так операция, которая уже начала перекладывать данные, всегда доходит до конца
+template <class F> void run_parts_nothrow(std::size_t parts, std::size_t count, F&& fn) noexcept {
+	auto job = [&](std::size_t part) { fn(part, count * part / parts, count * (part + 1) / parts); };
+	std::vector<std::thread> threads;
+	std::size_t started = 1;
+	try {
+		threads.reserve(parts - 1);
+		for (; started < parts; ++started) {
+			threads.emplace_back(job, started);
+		}
+	} catch (...) {
+		// потоков не хватило, остальные куски ниже
+	}
+	for (auto part = started; part < parts; ++part) {
+		job(part);
+	}
+	job(0);
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+} // namespace detail
+} // namespace tech
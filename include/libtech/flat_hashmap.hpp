@@ -0,0 +1,569 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <libtech/hash.hpp>
+#include <libtech/hash_traits.hpp>
+#include <libtech/vector.hpp>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LIBTECH_FLAT_SSE2 1
+#endif
+
+namespace tech {
+namespace detail {
+inline constexpr std::int8_t CTRL_EMPTY = -128;
+inline constexpr std::int8_t CTRL_DELETED = -2;
+inline constexpr std::size_t GROUP_WIDTH = 16;
+
+// 16 управляющих байт за раз: бит i маски соответствует слоту i группы
+class Group {
+#if defined(LIBTECH_FLAT_SSE2)
+	__m128i ctrl;
+
+  public:
+	explicit Group(const std::int8_t* pos)
+		: ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+	std::uint32_t match(std::int8_t h2) const {
+		return static_cast<std::uint32_t>(
+			_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+	}
+	std::uint32_t match_empty() const { return match(CTRL_EMPTY); }
+	std::uint32_t match_free() const {
+		return static_cast<std::uint32_t>(
+			_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl)));
+	}
+#else
+	const std::int8_t* ctrl;
+
+  public:
+	explicit Group(const std::int8_t* pos) : ctrl(pos) {}
+	std::uint32_t match(std::int8_t h2) const {
+		std::uint32_t mask = 0;
+		for (std::size_t i = 0; i < GROUP_WIDTH; ++i) {
+			mask |= static_cast<std::uint32_t>(ctrl[i] == h2) << i;
+		}
+		return mask;
+	}
+	std::uint32_t match_empty() const { return match(CTRL_EMPTY); }
+	std::uint32_t match_free() const {
+		std::uint32_t mask = 0;
+		for (std::size_t i = 0; i < GROUP_WIDTH; ++i) {
+			mask |= static_cast<std::uint32_t>(ctrl[i] < -1) << i;
+		}
+		return mask;
+	}
+#endif
+	std::uint32_t match_full() const { return ~match_free() & 0xFFFFU; }
+};
+} // namespace detail
+
+template <class Key, class T, class Hash = tech::Hash<Key>, class KeyEqual = std::equal_to<Key>, class Allocator = std::allocator<std::pair<Key, T>>> class FlatHashMap {
+  public:
+	using size_type = std::size_t;
+	using value_type = std::pair<Key, T>;
+	using key_type = Key;
+	using mapped_type = T;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using allocator_type = Allocator;
+
+  private:
+	// сырая память под пару, живые значения отмечены в ctrl
+	struct Slot {
+		alignas(value_type) std::byte storage[sizeof(value_type)];
+		value_type& value() { return *std::launder(reinterpret_cast<value_type*>(storage)); }
+		const value_type& value() const {
+			return *std::launder(reinterpret_cast<const value_type*>(storage));
+		}
+		value_type* raw() { return reinterpret_cast<value_type*>(storage); }
+	};
+	using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+	using ctrl_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::int8_t>;
+	using slots_type = Vector<Slot, slot_allocator>;
+	using ctrl_type = Vector<std::int8_t, ctrl_allocator>;
+	using alloc_traits = std::allocator_traits<Allocator>;
+
+	static constexpr const std::size_t INIT_CAPACITY = detail::GROUP_WIDTH;
+	static constexpr const float DEFAULT_MAX_LOAD_FACTOR = 0.875;
+	[[no_unique_address]] Allocator alloc;
+	slots_type slots;
+	ctrl_type ctrl;
+	Hash hash;
+	[[no_unique_address]] KeyEqual equal;
+	size_type items_count = 0;
+	size_type deleted_count = 0;
+	float max_saturation = DEFAULT_MAX_LOAD_FACTOR;
+
+  public:
+	template <class ValueType, class MapType> class Iterator {
+	  public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = ValueType;
+		using pointer = ValueType*;
+		using reference = ValueType&;
+		using iterator_category = std::forward_iterator_tag;
+		friend class FlatHashMap;
+
+	  private:
+		MapType* map;
+		size_type index;
+		void skip_free() {
+			// пропускаем пустые слоты целыми группами
+			while (index < map->bucket_count()) {
+				auto offset = index % detail::GROUP_WIDTH;
+				auto mask = detail::Group(map->ctrl.data() + index - offset).match_full() >> offset;
+				if (mask != 0) {
+					index += std::countr_zero(mask);
+					return;
+				}
+				index += detail::GROUP_WIDTH - offset;
+			}
+		}
+
+	  public:
+		Iterator(MapType* ptr, size_type pos) : map(ptr), index(pos) {}
+		reference operator*() const { return map->slots[index].value(); }
+		pointer operator->() const { return &map->slots[index].value(); }
+		bool operator==(const Iterator& another) const {
+			return index == another.index;
+		}
+		Iterator& operator++() {
+			++index;
+			skip_free();
+			return *this;
+		}
+		Iterator operator++(int) {
+			auto old = *this;
+			++(*this);
+			return old;
+		}
+	};
+	using iterator = Iterator<value_type, FlatHashMap>;
+	using const_iterator = Iterator<const value_type, const FlatHashMap>;
+
+  private:
+	// для erase и try_emplace K не должен путаться с итератором
+	template <class K>
+	static constexpr bool transparent_key = transparent_lookup<Hash, KeyEqual> &&
+		!std::is_convertible_v<K, iterator> && !std::is_convertible_v<K, const_iterator>;
+
+  public:
+	/* constructors */
+	FlatHashMap() : FlatHashMap(Allocator()) {}
+	explicit FlatHashMap(const Allocator& allocator)
+		: alloc(allocator), slots(alloc), ctrl(alloc), hash({}) {
+		init_slots(INIT_CAPACITY);
+	}
+	template <class InputIt>
+	FlatHashMap(InputIt first, InputIt last, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& allocator = Allocator())
+		: alloc(allocator), slots(alloc), ctrl(alloc), hash(_hash), equal(_equal) {
+		init_slots(capacity_for(std::max<size_type>(buckets_count, std::distance(first, last))));
+		insert(first, last);
+	}
+	FlatHashMap(std::initializer_list<value_type> init, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& allocator = Allocator())
+		: FlatHashMap(init.begin(), init.end(), buckets_count, _hash, _equal, allocator) {}
+	explicit FlatHashMap(size_type buckets_count, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& allocator = Allocator())
+		: alloc(allocator), slots(alloc), ctrl(alloc), hash(_hash), equal(_equal) {
+		init_slots(capacity_for(buckets_count));
+	}
+
+	/* rule of 5 */
+	FlatHashMap(const FlatHashMap& other)
+		: alloc(alloc_traits::select_on_container_copy_construction(other.alloc)),
+		  slots(alloc), ctrl(alloc), hash(other.hash_function()), equal(other.key_eq()), max_saturation(other.max_saturation) {
+		init_slots(other.bucket_count());
+		for (const auto& value : other) {
+			emplace(value);
+		}
+	}
+	FlatHashMap(FlatHashMap&& other) noexcept
+		: alloc(std::move(other.alloc)), slots(std::move(other.slots)), ctrl(std::move(other.ctrl)),
+		  hash(std::move(other.hash)), equal(std::move(other.equal)), items_count(other.items_count),
+		  deleted_count(other.deleted_count), max_saturation(other.max_saturation) {
+		other.items_count = 0;
+		other.deleted_count = 0;
+	}
+	FlatHashMap& operator=(const FlatHashMap& other) {
+		if (this == &other) {
+			return *this;
+		}
+		destroy_values();
+		if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+			alloc = other.alloc;
+		}
+		hash = other.hash;
+		equal = other.equal;
+		max_saturation = other.max_saturation;
+		items_count = 0;
+		deleted_count = 0;
+		init_slots(other.bucket_count());
+		for (const auto& value : other) {
+			emplace(value);
+		}
+		return *this;
+	}
+	FlatHashMap& operator=(FlatHashMap&& other) {
+		if (this == &other) {
+			return *this;
+		}
+		destroy_values();
+		hash = std::move(other.hash);
+		equal = std::move(other.equal);
+		max_saturation = other.max_saturation;
+		if constexpr (!alloc_traits::propagate_on_container_move_assignment::value) {
+			if (alloc != other.alloc) {
+				// слоты чужого аллокатора забрать нельзя, переносим значения
+				items_count = 0;
+				deleted_count = 0;
+				init_slots(other.bucket_count());
+				for (auto& value : other) {
+					emplace(std::move(value));
+				}
+				other.clear();
+				return *this;
+			}
+		} else {
+			alloc = std::move(other.alloc);
+		}
+		slots = std::move(other.slots);
+		ctrl = std::move(other.ctrl);
+		items_count = other.items_count;
+		deleted_count = other.deleted_count;
+		other.items_count = 0;
+		other.deleted_count = 0;
+		return *this;
+	}
+
+	allocator_type get_allocator() const noexcept { return alloc; }
+	~FlatHashMap() { destroy_values(); }
+
+	/* iterators */
+	iterator begin() noexcept {
+		iterator it(this, 0);
+		it.skip_free();
+		return it;
+	}
+	iterator end() noexcept { return iterator(this, bucket_count()); }
+	const_iterator begin() const noexcept {
+		const_iterator it(this, 0);
+		it.skip_free();
+		return it;
+	}
+	const_iterator end() const noexcept { return const_iterator(this, bucket_count()); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+
+	/* capacity */
+	size_type size() const noexcept { return items_count; }
+	bool empty() const noexcept { return size() == 0; }
+
+	/* modifiers */
+	void clear() noexcept {
+		destroy_values();
+		std::fill_n(ctrl.data(), bucket_count(), detail::CTRL_EMPTY);
+		items_count = 0;
+		deleted_count = 0;
+	}
+	std::pair<iterator, bool> insert(const value_type& value) {
+		return emplace(value);
+	}
+	std::pair<iterator, bool> insert(value_type&& value) {
+		return emplace(std::move(value));
+	}
+	template <class InputIt>
+	void insert(InputIt first, InputIt last) {
+		for (auto it = first; it != last; ++it) {
+			insert(*it);
+		}
+	}
+	iterator erase(iterator pos) {
+		if (pos == end()) {
+			return end();
+		}
+		erase_slot(pos.index);
+		++pos;
+		return pos;
+	}
+	template <class... Args>
+	std::pair<iterator, bool> emplace(Args&&... args) {
+		using extractor = detail::key_extractor_for<Key, Args...>;
+		if constexpr (extractor::value) {
+			// ключ виден в аргументах, пара строится сразу в слоте и только если ключа нет
+			const Key& key = extractor::get(args...);
+			auto h = hash_of(key);
+			auto [pos, found] = find_or_prepare(key, h);
+			if (!found) {
+				std::construct_at(slots[pos].raw(), std::forward<Args>(args)...);
+				occupy(pos, h);
+			}
+			return {iterator(this, pos), !found};
+		} else {
+			// ключ надо откуда-то взять, поэтому пара строится заранее и потом перемещается в слот
+			value_type value(std::forward<Args>(args)...);
+			auto h = hash_of(value.first);
+			auto [pos, found] = find_or_prepare(value.first, h);
+			if (!found) {
+				std::construct_at(slots[pos].raw(), std::move(value));
+				occupy(pos, h);
+			}
+			return {iterator(this, pos), !found};
+		}
+	}
+	template <class... Args>
+	iterator emplace_hint(const_iterator /*hint*/, Args&&... args) {
+		return emplace(std::forward<Args>(args)...).first;
+	}
+	template <class... Args>
+	std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+		return try_emplace_impl(key, std::forward<Args>(args)...);
+	}
+	template <class... Args>
+	std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+		return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+	}
+	template <class K, class... Args> requires transparent_key<K>
+	std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+		return try_emplace_impl(std::forward<K>(key), std::forward<Args>(args)...);
+	}
+	template <class M>
+	std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj) {
+		return insert_or_assign_impl(key, std::forward<M>(obj));
+	}
+	template <class M>
+	std::pair<iterator, bool> insert_or_assign(Key&& key, M&& obj) {
+		return insert_or_assign_impl(std::move(key), std::forward<M>(obj));
+	}
+	template <class K, class M> requires transparent_key<K>
+	std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj) {
+		return insert_or_assign_impl(std::forward<K>(key), std::forward<M>(obj));
+	}
+	size_type erase(const Key& key) { return erase_impl(key); }
+	template <class K> requires transparent_key<K>
+	size_type erase(K&& key) { return erase_impl(key); }
+
+	/* lookup */
+	T& operator[](const Key& key) { return try_emplace(key).first->second; }
+	T& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+	template <class K> requires transparent_key<K>
+	T& operator[](K&& key) { return try_emplace(std::forward<K>(key)).first->second; }
+	T& at(const Key& key) { return slots[at_index(key)].value().second; }
+	const T& at(const Key& key) const { return slots[at_index(key)].value().second; }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	T& at(const K& key) { return slots[at_index(key)].value().second; }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	const T& at(const K& key) const { return slots[at_index(key)].value().second; }
+	size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+	iterator find(const Key& key) { return iterator(this, find_index(key, hash_of(key))); }
+	const_iterator find(const Key& key) const {
+		return const_iterator(this, find_index(key, hash_of(key)));
+	}
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	iterator find(const K& key) { return iterator(this, find_index(key, hash_of(key))); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	const_iterator find(const K& key) const {
+		return const_iterator(this, find_index(key, hash_of(key)));
+	}
+	bool contains(const Key& key) const {
+		return find_index(key, hash_of(key)) != bucket_count();
+	}
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	bool contains(const K& key) const {
+		return find_index(key, hash_of(key)) != bucket_count();
+	}
+
+	/* bucket interface */
+	size_type bucket_count() const { return ctrl.size(); }
+	size_type bucket_size(size_type n) const { return ctrl[n] >= 0 ? 1 : 0; }
+
+	/* hash policy */
+	float load_factor() const { return static_cast<float>(size()) / bucket_count(); }
+	void rehash(size_type count) {
+		count = capacity_for(std::max<size_type>(count, std::ceil(size() / max_load_factor())));
+		if (count != bucket_count() || deleted_count != 0) {
+			resize(count);
+		}
+	}
+	void reserve(size_type count) { rehash(std::ceil(count / max_load_factor())); }
+	void max_load_factor(float lf) {
+		max_saturation = std::clamp(lf, 0.125F, 0.9375F);
+		if (size() + deleted_count > max_load_factor() * bucket_count()) {
+			reserve(size());
+		}
+	}
+	float max_load_factor() const { return max_saturation; }
+
+	/* observers */
+	Hash hash_function() const { return hash; }
+	KeyEqual key_eq() const { return equal; }
+
+  private:
+	static size_type capacity_for(size_type count) {
+		return std::bit_ceil(std::max(count, INIT_CAPACITY));
+	}
+	static std::int8_t h2(std::size_t h) { return static_cast<std::int8_t>(h & 0x7F); }
+	template <class K> std::size_t hash_of(const K& key) const { return detail::finalize_hash<Hash>(hash(key)); }
+	size_type group_mask() const { return bucket_count() / detail::GROUP_WIDTH - 1; }
+
+	void init_slots(size_type capacity) {
+		slots = slots_type(capacity, alloc);
+		slots.resize(capacity);
+		ctrl = ctrl_type(capacity, alloc);
+		ctrl.resize(capacity);
+		std::fill_n(ctrl.data(), capacity, detail::CTRL_EMPTY);
+	}
+	void destroy_values() noexcept {
+		for (size_type i = 0; i < bucket_count(); ++i) {
+			if (ctrl[i] >= 0) {
+				std::destroy_at(&slots[i].value());
+			}
+		}
+	}
+	void set_ctrl(size_type pos, std::int8_t value) { ctrl[pos] = value; }
+
+	// квадратичное пробирование по группам, группы выровнены по 16 байт
+	template <class K> size_type find_index(const K& key, std::size_t h) const {
+		if (bucket_count() == 0) {
+			// после перемещения таблицы нет
+			return bucket_count();
+		}
+		auto group = (h >> 7) & group_mask();
+		for (size_type step = 1;; ++step) {
+			auto base = group * detail::GROUP_WIDTH;
+			detail::Group g(ctrl.data() + base);
+			for (auto mask = g.match(h2(h)); mask != 0; mask &= mask - 1) {
+				auto pos = base + std::countr_zero(mask);
+				if (equal(slots[pos].value().first, key)) {
+					return pos;
+				}
+			}
+			if (g.match_empty() != 0 || step > group_mask()) {
+				return bucket_count();
+			}
+			group = (group + step) & group_mask();
+		}
+	}
+	size_type find_free(std::size_t h) const {
+		auto group = (h >> 7) & group_mask();
+		for (size_type step = 1;; ++step) {
+			auto base = group * detail::GROUP_WIDTH;
+			auto mask = detail::Group(ctrl.data() + base).match_free();
+			if (mask != 0) {
+				return base + std::countr_zero(mask);
+			}
+			group = (group + step) & group_mask();
+		}
+	}
+	// свободный слот еще не занят: его отмечает occupy, когда значение построено,
+	// так что исключение из конструктора оставляет таблицу как была
+	template <class K> std::pair<size_type, bool> find_or_prepare(const K& key, std::size_t h) {
+		auto pos = find_index(key, h);
+		if (pos != bucket_count()) {
+			return {pos, true};
+		}
+		if (size() + deleted_count + 1 > max_load_factor() * bucket_count()) {
+			// если мусора много, достаточно пересобрать таблицу того же размера
+			resize(capacity_for(deleted_count > size() / 2 ? bucket_count() : bucket_count() * 2));
+		}
+		return {find_free(h), false};
+	}
+	void occupy(size_type pos, std::size_t h) {
+		if (ctrl[pos] == detail::CTRL_DELETED) {
+			--deleted_count;
+		}
+		set_ctrl(pos, h2(h));
+		++items_count;
+	}
+	template <class K> size_type at_index(const K& key) const {
+		auto pos = find_index(key, hash_of(key));
+		if (pos == bucket_count()) {
+			throw std::out_of_range("No value with key\n");
+		}
+		return pos;
+	}
+	template <class K, class... Args>
+	std::pair<iterator, bool> try_emplace_impl(K&& key, Args&&... args) {
+		auto h = hash_of(key);
+		auto [pos, found] = find_or_prepare(key, h);
+		if (!found) {
+			std::construct_at(slots[pos].raw(), std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+							  std::forward_as_tuple(std::forward<Args>(args)...));
+			occupy(pos, h);
+		}
+		return {iterator(this, pos), !found};
+	}
+	template <class K, class M>
+	std::pair<iterator, bool> insert_or_assign_impl(K&& key, M&& obj) {
+		auto result = try_emplace_impl(std::forward<K>(key), std::forward<M>(obj));
+		if (!result.second) {
+			result.first->second = std::forward<M>(obj);
+		}
+		return result;
+	}
+	template <class K> size_type erase_impl(const K& key) {
+		auto pos = find_index(key, hash_of(key));
+		if (pos == bucket_count()) {
+			return 0;
+		}
+		erase_slot(pos);
+		return 1;
+	}
+	void erase_slot(size_type pos) {
+		std::destroy_at(&slots[pos].value());
+		auto base = pos - pos % detail::GROUP_WIDTH;
+		// если в группе есть пустой слот, поиск через неё не проходил, можно пометить пустым
+		if (detail::Group(ctrl.data() + base).match_empty() != 0) {
+			set_ctrl(pos, detail::CTRL_EMPTY);
+		} else {
+			set_ctrl(pos, detail::CTRL_DELETED);
+			++deleted_count;
+		}
+		--items_count;
+	}
+	// новые слоты выделяются до того, как трогать старые, значения переносятся через
+	// move_if_noexcept: если выделение или перенос бросит, карта остается как была
+	void resize(size_type capacity) {
+		slots_type new_slots(capacity, alloc);
+		new_slots.resize(capacity);
+		ctrl_type new_ctrl(capacity, alloc);
+		new_ctrl.resize(capacity);
+		std::fill_n(new_ctrl.data(), capacity, detail::CTRL_EMPTY);
+		auto old_slots = std::exchange(slots, std::move(new_slots));
+		auto old_ctrl = std::exchange(ctrl, std::move(new_ctrl));
+		try {
+			for (size_type i = 0; i < old_ctrl.size(); ++i) {
+				if (old_ctrl[i] >= 0) {
+					auto& value = old_slots[i].value();
+					auto h = hash_of(value.first);
+					auto pos = find_free(h);
+					std::construct_at(slots[pos].raw(), std::move_if_noexcept(value));
+					set_ctrl(pos, h2(h));
+				}
+			}
+		} catch (...) {
+			destroy_values();
+			slots = std::move(old_slots);
+			ctrl = std::move(old_ctrl);
+			throw;
+		}
+		deleted_count = 0;
+		for (size_type i = 0; i < old_ctrl.size(); ++i) {
+			if (old_ctrl[i] >= 0) {
+				std::destroy_at(&old_slots[i].value());
+			}
+		}
+	}
+};
+} // namespace tech
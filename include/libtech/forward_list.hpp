@@ -0,0 +1,217 @@
+#pragma once
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+namespace tech {
+namespace detail {
+// полный хеш в ноде, пустой тип если хранить не нужно
+template <bool Store> struct NodeHash {
+	constexpr void set(std::size_t /*h*/) noexcept {}
+	constexpr bool matches(std::size_t /*h*/) const noexcept { return true; }
+};
+template <> struct NodeHash<true> {
+	std::size_t value = 0;
+	constexpr void set(std::size_t h) noexcept { value = h; }
+	constexpr bool matches(std::size_t h) const noexcept { return value == h; }
+};
+} // namespace detail
+
+// односвязный список для ведер HashMap: назад по ведру никто не ходит,
+// поэтому на ноду хватает значения и одного указателя
+template <class T, class Allocator = std::allocator<T>, bool StoreHash = false> class ForwardList {
+  public:
+	/* member types */
+
+	using value_type = T;
+	struct Node {
+		T value;
+		Node* next;
+		[[no_unique_address]] detail::NodeHash<StoreHash> hash_code;
+		template <class... Args>
+		Node(Args&&... args) : value(std::forward<Args>(args)...), next(nullptr), hash_code() {}
+	};
+	using node_type = Node;
+	using allocator_type = Allocator;
+	using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+	template <class ValueType> class Iterator {
+	  public:
+		Node* current;
+		using difference_type = std::ptrdiff_t;
+		using value_type = ValueType;
+		using pointer = ValueType*;
+		using reference = ValueType&;
+		using iterator_category = std::forward_iterator_tag;
+		explicit Iterator(Node* ptr) : current(ptr) {}
+		reference operator*() const { return current->value; }
+		pointer operator->() const { return &current->value; }
+		bool operator==(const Iterator& another) const {
+			return current == another.current;
+		}
+		Iterator& operator++() {
+			if (current) {
+				current = current->next;
+			}
+			return *this;
+		}
+		Iterator operator++(int) {
+			auto old = *this;
+			++(*this);
+			return old;
+		}
+	};
+	using iterator = Iterator<T>;
+	using const_iterator = Iterator<const T>;
+
+	/* constructors */
+	ForwardList() : ForwardList(Allocator()) {}
+	explicit ForwardList(const Allocator& allocator) : alloc(allocator) {}
+
+	/* rule of 5 */
+	ForwardList(const ForwardList& list)
+		: alloc(node_traits::select_on_container_copy_construction(list.alloc)) {
+		copy_from(list);
+	}
+	ForwardList(ForwardList&& list) noexcept
+		: first(list.first), count(list.count), alloc(std::move(list.alloc)) {
+		list.first = nullptr;
+		list.count = 0;
+	}
+	ForwardList& operator=(const ForwardList& list) {
+		if (this == &list) {
+			return *this;
+		}
+		clear();
+		if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+			alloc = list.alloc;
+		}
+		copy_from(list);
+		return *this;
+	}
+	ForwardList& operator=(ForwardList&& list) {
+		if (this == &list) {
+			return *this;
+		}
+		clear();
+		if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+			alloc = std::move(list.alloc);
+		} else if (alloc != list.alloc) {
+			Node** tail = &first;
+			for (auto& item : list) {
+				*tail = create_node(alloc, std::move(item));
+				tail = &(*tail)->next;
+				++count;
+			}
+			list.clear();
+			return *this;
+		}
+		first = list.first;
+		count = list.count;
+		list.first = nullptr;
+		list.count = 0;
+		return *this;
+	}
+	~ForwardList() { clear(); }
+
+	allocator_type get_allocator() const noexcept { return allocator_type(alloc); }
+
+	/* element access */
+	T& front() { return first->value; }
+
+	/* iterators */
+	Iterator<T> begin() noexcept { return Iterator<T>(first); }
+	Iterator<T> end() noexcept { return Iterator<T>(nullptr); }
+	Iterator<const T> begin() const noexcept { return Iterator<const T>(first); }
+	Iterator<const T> end() const noexcept { return Iterator<const T>(nullptr); }
+	Iterator<const T> cbegin() const noexcept { return Iterator<const T>(first); }
+	Iterator<const T> cend() const noexcept { return Iterator<const T>(nullptr); }
+
+	/* capacity */
+	std::size_t size() const noexcept { return count; }
+	bool empty() const noexcept { return first == nullptr; }
+
+	/* modifiers */
+	void clear() noexcept {
+		while (first) {
+			auto* next = first->next;
+			destroy_node(alloc, first);
+			first = next;
+		}
+		count = 0;
+	}
+	Node* push_front(const T& value) { return push_front(create_node(alloc, value)); }
+	Node* push_front(T&& value) { return push_front(create_node(alloc, std::move(value))); }
+	Node* push_front(Node* node) {
+		node->next = first;
+		first = node;
+		++count;
+		return node;
+	}
+	// вставка за нодой pos: равные ключи HashMultiMap так остаются в ведре подряд
+	Node* insert_after(Node* pos, Node* node) noexcept {
+		node->next = pos->next;
+		pos->next = node;
+		++count;
+		return node;
+	}
+	template <class... Args> Node* emplace_front(Args&&... args) {
+		return push_front(create_node(alloc, std::forward<Args>(args)...));
+	}
+	// отцепляет первую ноду, не уничтожая её
+	Node* release_front() noexcept {
+		auto* node = first;
+		first = node->next;
+		node->next = nullptr;
+		--count;
+		return node;
+	}
+	// отцепляет ноду из середины, предыдущую приходится искать
+	Node* release(Node* node) noexcept {
+		Node** link = &first;
+		while (*link != node) {
+			link = &(*link)->next;
+		}
+		*link = node->next;
+		node->next = nullptr;
+		--count;
+		return node;
+	}
+	Iterator<T> erase(Iterator<T> pos) {
+		auto* next = pos.current->next;
+		destroy_node(alloc, release(pos.current));
+		return Iterator<T>(next);
+	}
+	void pop_front() { destroy_node(alloc, release_front()); }
+
+	// ноды можно создавать отдельно от списка, главное тем же аллокатором
+	template <class... Args> static Node* create_node(node_allocator& allocator, Args&&... args) {
+		Node* node = node_traits::allocate(allocator, 1);
+		try {
+			std::construct_at(node, std::forward<Args>(args)...);
+		} catch (...) {
+			node_traits::deallocate(allocator, node, 1);
+			throw;
+		}
+		return node;
+	}
+	static void destroy_node(node_allocator& allocator, Node* node) noexcept {
+		std::destroy_at(node);
+		node_traits::deallocate(allocator, node, 1);
+	}
+
+  private:
+	using node_traits = std::allocator_traits<node_allocator>;
+	Node* first = nullptr;
+	std::size_t count = 0;
+	[[no_unique_address]] node_allocator alloc;
+
+	void copy_from(const ForwardList& list) {
+		Node** tail = &first;
+		for (const auto& item : list) {
+			*tail = create_node(alloc, item);
+			tail = &(*tail)->next;
+			++count;
+		}
+	}
+};
+}
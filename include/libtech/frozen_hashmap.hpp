@@ -0,0 +1,417 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <libtech/hash.hpp>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LIBTECH_HAS_MMAP 1
+#endif
+
+namespace tech {
+namespace detail {
+// файл, отображенный в память только для чтения. Где mmap нет, файл читается в буфер
+class FileMapping {
+  public:
+	FileMapping() = default;
+	explicit FileMapping(const std::filesystem::path& path) {
+#if defined(LIBTECH_HAS_MMAP)
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw std::system_error(errno, std::generic_category(), "open " + path.string());
+		}
+		struct stat info {};
+		if (::fstat(fd, &info) != 0) {
+			auto error = errno;
+			::close(fd);
+			throw std::system_error(error, std::generic_category(), "fstat " + path.string());
+		}
+		bytes = static_cast<std::size_t>(info.st_size);
+		if (bytes != 0) {
+			void* mapped = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+			if (mapped == MAP_FAILED) {
+				auto error = errno;
+				::close(fd);
+				throw std::system_error(error, std::generic_category(), "mmap " + path.string());
+			}
+			address = static_cast<const std::byte*>(mapped);
+		}
+		// отображение живет и без дескриптора
+		::close(fd);
+#else
+		std::ifstream in(path, std::ios::binary | std::ios::ate);
+		if (!in) {
+			throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), "open " + path.string());
+		}
+		bytes = static_cast<std::size_t>(in.tellg());
+		// буфер из uint64_t, чтобы записи были выровнены так же, как при mmap
+		buffer = std::make_unique<std::uint64_t[]>((bytes + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+		in.seekg(0);
+		in.read(reinterpret_cast<char*>(buffer.get()), static_cast<std::streamsize>(bytes));
+		address = reinterpret_cast<const std::byte*>(buffer.get());
+#endif
+	}
+	FileMapping(const FileMapping&) = delete;
+	FileMapping(FileMapping&& other) noexcept
+		: address(std::exchange(other.address, nullptr)), bytes(std::exchange(other.bytes, 0))
+#if !defined(LIBTECH_HAS_MMAP)
+		  ,
+		  buffer(std::move(other.buffer))
+#endif
+	{
+	}
+	FileMapping& operator=(const FileMapping&) = delete;
+	FileMapping& operator=(FileMapping&& other) noexcept {
+		if (this != &other) {
+			unmap();
+			address = std::exchange(other.address, nullptr);
+			bytes = std::exchange(other.bytes, 0);
+#if !defined(LIBTECH_HAS_MMAP)
+			buffer = std::move(other.buffer);
+#endif
+		}
+		return *this;
+	}
+	~FileMapping() { unmap(); }
+	std::span<const std::byte> data() const noexcept { return {address, bytes}; }
+
+  private:
+	void unmap() noexcept {
+#if defined(LIBTECH_HAS_MMAP)
+		if (address) {
+			::munmap(const_cast<std::byte*>(address), bytes);
+		}
+#endif
+		address = nullptr;
+		bytes = 0;
+	}
+	const std::byte* address = nullptr;
+	std::size_t bytes = 0;
+#if !defined(LIBTECH_HAS_MMAP)
+	std::unique_ptr<std::uint64_t[]> buffer;
+#endif
+};
+
+struct FrozenHeader {
+	static constexpr const char MAGIC[8] = {'T', 'E', 'C', 'H', 'F', 'H', 'M', '\0'};
+	static constexpr const std::uint32_t VERSION = 1;
+	static constexpr const std::uint32_t ENDIAN_MARK = 0x01020304;
+	char magic[8];
+	std::uint32_t version;
+	// файл пишется в порядке байт машины, чужой порядок не откроется
+	std::uint32_t byte_order;
+	// размеры, по которым ловится открытие файла не с теми типами
+	std::uint64_t string_keys;
+	std::uint64_t key_size;
+	std::uint64_t value_size;
+	std::uint64_t entry_size;
+	std::uint64_t size;
+	std::uint64_t bucket_count;
+	// смещения секций от начала файла
+	std::uint64_t buckets_offset;
+	std::uint64_t entries_offset;
+	std::uint64_t strings_offset;
+	std::uint64_t file_size;
+};
+inline constexpr const std::size_t FROZEN_ALIGNMENT = 64;
+constexpr std::uint64_t frozen_align(std::uint64_t offset) {
+	return (offset + FROZEN_ALIGNMENT - 1) / FROZEN_ALIGNMENT * FROZEN_ALIGNMENT;
+}
+} // namespace detail
+
+// неизменяемая хеш-таблица в одном плоском файле: вместо указателей смещения, так что файл
+// открывается через mmap за O(1) без разбора и делится между процессами только для чтения.
+//
+// Раскладка: заголовок, bucket_count + 1 начал ведер, записи {хеш, ключ, значение},
+// отсортированные по ведрам, и для строковых ключей пул строк. Ключи - тривиально копируемые
+// типы или std::string (в записи смещение и длина в пуле), значения - тривиально копируемые.
+// Хеш должен давать одно и то же во всех процессах: tech::Hash это гарантирует
+template <class Key, class T, class Hash = tech::Hash<Key>, class KeyEqual = std::equal_to<Key>> class FrozenHashMap {
+	static constexpr bool string_keys = std::is_same_v<Key, std::string>;
+	static_assert(string_keys || std::is_trivially_copyable_v<Key>, "FrozenHashMap keys must be trivially copyable or std::string");
+	static_assert(std::is_trivially_copyable_v<T>, "FrozenHashMap values must be trivially copyable");
+
+	struct StringRef {
+		std::uint64_t offset;
+		std::uint64_t length;
+	};
+	struct Entry {
+		std::uint64_t hash;
+		std::conditional_t<string_keys, StringRef, Key> key;
+		T value;
+	};
+	static_assert(alignof(Entry) <= detail::FROZEN_ALIGNMENT);
+
+  public:
+	using size_type = std::size_t;
+	using key_type = Key;
+	using mapped_type = T;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	// ключ для поиска и то, что отдает обход: строки видны как std::string_view на файл
+	using lookup_type = std::conditional_t<string_keys, std::string_view, Key>;
+	using key_reference = std::conditional_t<string_keys, std::string_view, const Key&>;
+	using value_type = std::pair<key_reference, const T&>;
+
+	class const_iterator {
+	  public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = FrozenHashMap::value_type;
+		using reference = value_type;
+		using iterator_category = std::forward_iterator_tag;
+
+		const_iterator() = default;
+		const_iterator(const FrozenHashMap* owner, const Entry* pos) : map(owner), entry(pos) {}
+		// пара ссылок в файл, собирается на лету
+		reference operator*() const { return {map->key_of(*entry), entry->value}; }
+		bool operator==(const const_iterator& another) const { return entry == another.entry; }
+		const_iterator& operator++() {
+			++entry;
+			return *this;
+		}
+		const_iterator operator++(int) {
+			auto old = *this;
+			++entry;
+			return old;
+		}
+
+	  private:
+		const FrozenHashMap* map = nullptr;
+		const Entry* entry = nullptr;
+	};
+	using iterator = const_iterator;
+
+	/* constructors */
+	// образ в чужой памяти, выровненной на 8 байт; память должна пережить карту
+	explicit FrozenHashMap(std::span<const std::byte> image, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual())
+		: hash(_hash), equal(_equal) {
+		attach(image);
+	}
+	// отображение файла, записанного save
+	static FrozenHashMap open(const std::filesystem::path& path, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual()) {
+		detail::FileMapping mapping(path);
+		FrozenHashMap map(mapping.data(), _hash, _equal);
+		map.mapping = std::move(mapping);
+		return map;
+	}
+	FrozenHashMap(const FrozenHashMap&) = delete;
+	// источник остается пустым: его указатели смотрели бы в отображение, которым он больше не владеет
+	FrozenHashMap(FrozenHashMap&& other) noexcept
+		: mapping(std::move(other.mapping)), header(std::exchange(other.header, nullptr)),
+		  starts(std::exchange(other.starts, nullptr)), entries(std::exchange(other.entries, nullptr)),
+		  strings(std::exchange(other.strings, nullptr)), hash(std::move(other.hash)), equal(std::move(other.equal)) {}
+	FrozenHashMap& operator=(const FrozenHashMap&) = delete;
+	FrozenHashMap& operator=(FrozenHashMap&& other) noexcept {
+		if (this != &other) {
+			mapping = std::move(other.mapping);
+			header = std::exchange(other.header, nullptr);
+			starts = std::exchange(other.starts, nullptr);
+			entries = std::exchange(other.entries, nullptr);
+			strings = std::exchange(other.strings, nullptr);
+			hash = std::move(other.hash);
+			equal = std::move(other.equal);
+		}
+		return *this;
+	}
+	~FrozenHashMap() = default;
+
+	/* запись */
+	// map - любая карта с обходом по парам (HashMap, FlatHashMap, std::unordered_map)
+	template <class Map> static void save(const Map& map, std::ostream& out, const Hash& _hash = Hash()) {
+		const std::uint64_t count = map.size();
+		const std::uint64_t buckets = std::bit_ceil(std::max<std::uint64_t>(count, 1));
+		std::vector<Entry> entries;
+		entries.reserve(count);
+		std::string strings;
+		for (const auto& [key, value] : map) {
+			// через {} нули и в выравнивании: одинаковые карты дают одинаковые файлы
+			Entry entry{};
+			entry.hash = hash_of(_hash, key);
+			if constexpr (string_keys) {
+				entry.key = {strings.size(), key.size()};
+				strings.append(key);
+			} else {
+				entry.key = key;
+			}
+			entry.value = value;
+			entries.push_back(entry);
+		}
+		// сортировка подсчетом по ведрам
+		std::vector<std::uint64_t> starts(buckets + 1, 0);
+		for (const auto& entry : entries) {
+			++starts[(entry.hash & (buckets - 1)) + 1];
+		}
+		for (std::uint64_t i = 0; i < buckets; ++i) {
+			starts[i + 1] += starts[i];
+		}
+		std::vector<Entry> sorted(entries.size());
+		auto next = starts;
+		for (const auto& entry : entries) {
+			sorted[next[entry.hash & (buckets - 1)]++] = entry;
+		}
+
+		detail::FrozenHeader header{};
+		std::memcpy(header.magic, detail::FrozenHeader::MAGIC, sizeof(header.magic));
+		header.version = detail::FrozenHeader::VERSION;
+		header.byte_order = detail::FrozenHeader::ENDIAN_MARK;
+		header.string_keys = string_keys;
+		header.key_size = sizeof(Key);
+		header.value_size = sizeof(T);
+		header.entry_size = sizeof(Entry);
+		header.size = count;
+		header.bucket_count = buckets;
+		header.buckets_offset = detail::frozen_align(sizeof(header));
+		header.entries_offset = detail::frozen_align(header.buckets_offset + starts.size() * sizeof(std::uint64_t));
+		header.strings_offset = detail::frozen_align(header.entries_offset + sorted.size() * sizeof(Entry));
+		header.file_size = header.strings_offset + strings.size();
+
+		std::uint64_t written = 0;
+		auto write = [&](std::uint64_t offset, const void* data, std::uint64_t bytes) {
+			static constexpr const char ZEROS[detail::FROZEN_ALIGNMENT] = {};
+			out.write(ZEROS, static_cast<std::streamsize>(offset - written));
+			out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+			written = offset + bytes;
+		};
+		write(0, &header, sizeof(header));
+		write(header.buckets_offset, starts.data(), starts.size() * sizeof(std::uint64_t));
+		write(header.entries_offset, sorted.data(), sorted.size() * sizeof(Entry));
+		write(header.strings_offset, strings.data(), strings.size());
+		if (!out) {
+			throw std::runtime_error("FrozenHashMap: write failed\n");
+		}
+	}
+	template <class Map> static void save(const Map& map, const std::filesystem::path& path, const Hash& _hash = Hash()) {
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			throw std::system_error(errno, std::generic_category(), "open " + path.string());
+		}
+		save(map, out, _hash);
+	}
+
+	/* iterators */
+	const_iterator begin() const noexcept { return const_iterator(this, entries); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator end() const noexcept { return const_iterator(this, entries + size()); }
+	const_iterator cend() const noexcept { return end(); }
+
+	/* capacity */
+	bool empty() const noexcept { return size() == 0; }
+	size_type size() const noexcept { return header ? header->size : 0; }
+	size_type bucket_count() const noexcept { return header ? header->bucket_count : 0; }
+
+	/* lookup */
+	const_iterator find(const lookup_type& key) const { return const_iterator(this, find_entry(key)); }
+	bool contains(const lookup_type& key) const { return find_entry(key) != entries + size(); }
+	size_type count(const lookup_type& key) const { return contains(key) ? 1 : 0; }
+	const T& at(const lookup_type& key) const {
+		auto* entry = find_entry(key);
+		if (entry == entries + size()) {
+			throw std::out_of_range("No value with key\n");
+		}
+		return entry->value;
+	}
+
+	/* observers */
+	Hash hash_function() const { return hash; }
+	KeyEqual key_eq() const { return equal; }
+
+  private:
+	template <class K> static std::size_t hash_of(const Hash& _hash, const K& key) {
+		if constexpr (string_keys && !std::is_invocable_v<const Hash&, std::string_view>) {
+			return detail::finalize_hash<Hash>(_hash(std::string(key)));
+		} else {
+			return detail::finalize_hash<Hash>(_hash(key));
+		}
+	}
+	key_reference key_of(const Entry& entry) const {
+		if constexpr (string_keys) {
+			return {strings + entry.key.offset, entry.key.length};
+		} else {
+			return entry.key;
+		}
+	}
+	const Entry* find_entry(const lookup_type& key) const {
+		if (!header) {
+			// после перемещения
+			return entries + size();
+		}
+		std::uint64_t h = hash_of(hash, key);
+		auto bucket = h & (bucket_count() - 1);
+		for (auto* entry = entries + starts[bucket], *last = entries + starts[bucket + 1]; entry != last; ++entry) {
+			if (entry->hash != h) {
+				continue;
+			}
+			if constexpr (string_keys) {
+				if (key_of(*entry) == key) {
+					return entry;
+				}
+			} else if (equal(entry->key, key)) {
+				return entry;
+			}
+		}
+		return entries + size();
+	}
+	// проверяется только заголовок: O(1), содержимому файла доверяем
+	void attach(std::span<const std::byte> image) {
+		auto fail = [](const char* what) { throw std::runtime_error(std::string("FrozenHashMap: ") + what + "\n"); };
+		if (image.size() < sizeof(detail::FrozenHeader)) {
+			fail("image is too small");
+		}
+		if (reinterpret_cast<std::uintptr_t>(image.data()) % alignof(std::uint64_t) != 0) {
+			fail("image is not aligned");
+		}
+		header = reinterpret_cast<const detail::FrozenHeader*>(image.data());
+		if (std::memcmp(header->magic, detail::FrozenHeader::MAGIC, sizeof(header->magic)) != 0) {
+			fail("bad magic");
+		}
+		if (header->version != detail::FrozenHeader::VERSION || header->byte_order != detail::FrozenHeader::ENDIAN_MARK) {
+			fail("unsupported version or byte order");
+		}
+		if (header->string_keys != static_cast<std::uint64_t>(string_keys) || header->key_size != sizeof(Key) ||
+			header->value_size != sizeof(T) || header->entry_size != sizeof(Entry)) {
+			fail("key or value type does not match");
+		}
+		if (header->file_size > image.size() || !std::has_single_bit(header->bucket_count) ||
+			header->bucket_count > header->file_size / sizeof(std::uint64_t) ||
+			header->size > header->file_size / sizeof(Entry) ||
+			header->buckets_offset + (header->bucket_count + 1) * sizeof(std::uint64_t) > header->entries_offset ||
+			header->entries_offset + header->size * sizeof(Entry) > header->strings_offset ||
+			header->strings_offset > header->file_size) {
+			fail("corrupted layout");
+		}
+		starts = reinterpret_cast<const std::uint64_t*>(image.data() + header->buckets_offset);
+		entries = reinterpret_cast<const Entry*>(image.data() + header->entries_offset);
+		strings = reinterpret_cast<const char*>(image.data() + header->strings_offset);
+	}
+
+	detail::FileMapping mapping;
+	const detail::FrozenHeader* header = nullptr;
+	const std::uint64_t* starts = nullptr;
+	const Entry* entries = nullptr;
+	const char* strings = nullptr;
+	Hash hash;
+	[[no_unique_address]] KeyEqual equal;
+};
+} // namespace tech
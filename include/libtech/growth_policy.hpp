@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <ratio>
+
+namespace tech {
+namespace detail {
+#if defined(__SIZEOF_INT128__)
+__extension__ using uint128_t = unsigned __int128;
+
+// деление на константу через заранее посчитанное магическое число (Lemire, fastmod)
+constexpr uint128_t fastmod_magic(std::uint64_t d) {
+	return ~uint128_t(0) / d + 1;
+}
+constexpr std::uint64_t fastmod(std::uint64_t a, uint128_t magic, std::uint64_t d) {
+	uint128_t lowbits = magic * a;
+	uint128_t bottom = ((lowbits & ~std::uint64_t(0)) * d) >> 64;
+	uint128_t top = (lowbits >> 64) * d;
+	return static_cast<std::uint64_t>((bottom + top) >> 64);
+}
+#endif
+
+template <class Factor> constexpr std::size_t scale(std::size_t count) {
+	static_assert(Factor::num > Factor::den, "growth factor must be greater than 1");
+	return std::max(count + 1, count / Factor::den * Factor::num + count % Factor::den * Factor::num / Factor::den);
+}
+
+inline constexpr std::array PRIMES = {
+	1ULL, 2ULL, 3ULL, 5ULL, 7ULL, 11ULL, 13ULL, 17ULL, 23ULL, 29ULL, 37ULL,
+	47ULL, 59ULL, 73ULL, 97ULL, 127ULL, 163ULL, 211ULL, 269ULL, 337ULL,
+	431ULL, 541ULL, 677ULL, 853ULL, 1069ULL, 1361ULL, 1709ULL, 2137ULL,
+	2677ULL, 3347ULL, 4201ULL, 5261ULL, 6577ULL, 8231ULL, 10289ULL, 12889ULL,
+	16127ULL, 20161ULL, 25219ULL, 31531ULL, 39419ULL, 49277ULL, 61603ULL,
+	77017ULL, 96281ULL, 120371ULL, 150473ULL, 188107ULL, 235159ULL, 293957ULL,
+	367453ULL, 459317ULL, 574157ULL, 717697ULL, 897133ULL, 1121423ULL,
+	1401791ULL, 1752239ULL, 2190299ULL, 2737937ULL, 3422429ULL, 4278037ULL,
+	5347553ULL, 6684443ULL, 8355563ULL, 10444457ULL, 13055587ULL, 16319519ULL,
+	20399411ULL, 25499291ULL, 31874149ULL, 39842687ULL, 49803361ULL,
+	62254207ULL, 77817767ULL, 97272239ULL, 121590311ULL, 151987889ULL,
+	189984863ULL, 237481091ULL, 296851369ULL, 371064217ULL, 463830313ULL,
+	579787991ULL, 724735009ULL, 905918777ULL, 1132398479ULL, 1415498113ULL,
+	1769372713ULL, 2211715897ULL, 2764644887ULL, 3455806139ULL, 4319757679ULL,
+	5399697103ULL, 6749621381ULL, 8437026733ULL, 10546283443ULL,
+	13182854383ULL, 16478568031ULL, 20598210049ULL, 25747762577ULL,
+	32184703259ULL, 40230879079ULL, 50288598869ULL, 62860748591ULL,
+	78575935741ULL, 98219919691ULL, 122774899661ULL, 153468624587ULL,
+	191835780739ULL, 239794725967ULL, 299743407493ULL, 374679259379ULL,
+	468349074241ULL, 585436342807ULL, 731795428531ULL, 914744285671ULL,
+	1143430357117ULL, 1429287946403ULL, 1786609933007ULL, 2233262416267ULL,
+	2791578020339ULL, 3489472525447ULL, 4361840656829ULL, 5452300821049ULL,
+	6815376026323ULL, 8519220032929ULL, 10649025041231ULL, 13311281301583ULL,
+	16639101626981ULL, 20798877033733ULL, 25998596292191ULL,
+	32498245365251ULL, 40622806706567ULL, 50778508383221ULL,
+	63473135479027ULL, 79341419348791ULL, 99176774185997ULL,
+	123970967732519ULL, 154963709665651ULL, 193704637082069ULL,
+	242130796352587ULL, 302663495440751ULL, 378329369300959ULL,
+	472911711626243ULL, 591139639532851ULL, 738924549416087ULL,
+	923655686770121ULL, 1154569608462691ULL, 1443212010578369ULL,
+	1804015013222963ULL, 2255018766528791ULL, 2818773458160997ULL,
+	3523466822701261ULL, 4404333528376583ULL, 5505416910470779ULL,
+	6881771138088491ULL, 8602213922610661ULL, 10752767403263341ULL,
+	13440959254079207ULL, 16801199067599021ULL, 21001498834498823ULL,
+	26251873543123681ULL, 32814841928904653ULL, 41018552411130823ULL,
+	51273190513913551ULL, 64091488142391953ULL, 80114360177989987ULL,
+	100142950222487567ULL, 125178687778109509ULL, 156473359722636923ULL,
+	195591699653296207ULL, 244489624566620267ULL, 305612030708275331ULL,
+	382015038385344137ULL, 477518797981680139ULL, 596898497477100163ULL,
+	746123121846375181ULL, 932653902307969027ULL, 1165817377884961349ULL,
+	1457271722356201613ULL, 1821589652945252167ULL, 2276987066181565189ULL,
+	2846233832726956597ULL, 3557792290908695591ULL, 4447240363635869711ULL,
+	5559050454544836643ULL, 6948813068181045337ULL, 8686016335226306563ULL
+};
+} // namespace detail
+
+/* growth policies
+ * bucket_count_for(n) - округляет запрошенное количество ведер вверх
+ * reset(n) - запоминает текущее количество ведер
+ * index(h) - номер ведра для хеша
+ * next_bucket_count(n) - сколько ведер нужно после n при переполнении
+ */
+
+template <std::size_t Factor = 2> class PowerOfTwoGrowthPolicy {
+	static_assert(Factor >= 2 && std::has_single_bit(Factor), "growth factor must be a power of two");
+	std::size_t mask = 0;
+
+  public:
+	static constexpr std::size_t bucket_count_for(std::size_t count) {
+		return count < 2 ? 1 : std::bit_ceil(count);
+	}
+	constexpr void reset(std::size_t bucket_count) { mask = bucket_count - 1; }
+	constexpr std::size_t index(std::size_t h) const { return h & mask; }
+	constexpr std::size_t next_bucket_count(std::size_t bucket_count) const {
+		return bucket_count * Factor;
+	}
+};
+
+template <class Factor = std::ratio<2>> class PrimeGrowthPolicy {
+	std::size_t prime = 1;
+#if defined(__SIZEOF_INT128__)
+	detail::uint128_t magic = detail::fastmod_magic(1);
+#endif
+
+  public:
+	static constexpr std::size_t bucket_count_for(std::size_t count) {
+		auto it = std::lower_bound(detail::PRIMES.begin(), detail::PRIMES.end(), count);
+		return it == detail::PRIMES.end() ? detail::PRIMES.back() : *it;
+	}
+	constexpr void reset(std::size_t bucket_count) {
+		prime = bucket_count;
+#if defined(__SIZEOF_INT128__)
+		magic = detail::fastmod_magic(bucket_count);
+#endif
+	}
+	constexpr std::size_t index(std::size_t h) const {
+#if defined(__SIZEOF_INT128__)
+		return detail::fastmod(h, magic, prime);
+#else
+		return h % prime;
+#endif
+	}
+	constexpr std::size_t next_bucket_count(std::size_t bucket_count) const {
+		return bucket_count_for(detail::scale<Factor>(bucket_count));
+	}
+};
+
+template <class Factor = std::ratio<2>> class ModuloGrowthPolicy {
+	std::size_t buckets = 1;
+
+  public:
+	static constexpr std::size_t bucket_count_for(std::size_t count) {
+		return count < 1 ? 1 : count;
+	}
+	constexpr void reset(std::size_t bucket_count) { buckets = bucket_count; }
+	constexpr std::size_t index(std::size_t h) const { return h % buckets; }
+	constexpr std::size_t next_bucket_count(std::size_t bucket_count) const {
+		return detail::scale<Factor>(bucket_count);
+	}
+};
+} // namespace tech
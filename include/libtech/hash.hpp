@@ -0,0 +1,162 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <libtech/hash_traits.hpp>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace tech {
+namespace detail {
+// 64x64 -> 128 и xor половин: основа и перемешивания, и хеша строк (как в wyhash)
+constexpr std::uint64_t mum(std::uint64_t a, std::uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+	__extension__ using wide = unsigned __int128;
+	wide r = static_cast<wide>(a) * b;
+	return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+#else
+	std::uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32, b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+	std::uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+	std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+	std::uint64_t lo = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+	std::uint64_t hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+	return lo ^ hi;
+#endif
+}
+
+inline constexpr std::uint64_t SECRET[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL,
+											0x4d5a2da51de1aa47ULL};
+
+// каждый бит входа влияет на все биты выхода: годится и для маски, и для старших битов
+constexpr std::uint64_t mix64(std::uint64_t x) noexcept { return mum(x ^ SECRET[0], SECRET[1]); }
+
+// чтение little-endian побайтно: компилятор собирает это в одну загрузку,
+// а хеш остается constexpr и одинаковым на любой платформе
+template <class Byte> constexpr std::uint64_t read64(const Byte* p) noexcept {
+	std::uint64_t result = 0;
+	for (int i = 0; i < 8; ++i) {
+		result |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+	}
+	return result;
+}
+template <class Byte> constexpr std::uint64_t read32(const Byte* p) noexcept {
+	std::uint64_t result = 0;
+	for (int i = 0; i < 4; ++i) {
+		result |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+	}
+	return result;
+}
+template <class Byte> constexpr std::uint64_t read_small(const Byte* p, std::size_t len) noexcept {
+	return (static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) << 16) |
+		   (static_cast<std::uint64_t>(static_cast<unsigned char>(p[len >> 1])) << 8) |
+		   static_cast<std::uint64_t>(static_cast<unsigned char>(p[len - 1]));
+}
+
+// wyhash: по 48 байт за шаг в три независимые цепочки умножений, хвост до 16 байт
+template <class Byte> constexpr std::uint64_t hash_bytes(const Byte* p, std::size_t len, std::uint64_t seed) noexcept {
+	seed ^= mum(seed ^ SECRET[0], SECRET[1]);
+	std::uint64_t a = 0;
+	std::uint64_t b = 0;
+	if (len <= 16) {
+		if (len >= 4) {
+			auto shift = (len >> 3) << 2;
+			a = (read32(p) << 32) | read32(p + shift);
+			b = (read32(p + len - 4) << 32) | read32(p + len - 4 - shift);
+		} else if (len > 0) {
+			a = read_small(p, len);
+		}
+	} else {
+		auto rest = len;
+		if (rest > 48) {
+			auto see1 = seed;
+			auto see2 = seed;
+			do {
+				seed = mum(read64(p) ^ SECRET[1], read64(p + 8) ^ seed);
+				see1 = mum(read64(p + 16) ^ SECRET[2], read64(p + 24) ^ see1);
+				see2 = mum(read64(p + 32) ^ SECRET[3], read64(p + 40) ^ see2);
+				p += 48;
+				rest -= 48;
+			} while (rest > 48);
+			seed ^= see1 ^ see2;
+		}
+		while (rest > 16) {
+			seed = mum(read64(p) ^ SECRET[1], read64(p + 8) ^ seed);
+			p += 16;
+			rest -= 16;
+		}
+		a = read64(p + rest - 16);
+		b = read64(p + rest - 8);
+	}
+	return mum(SECRET[1] ^ len, mum(a ^ SECRET[1], b ^ seed));
+}
+
+// хеш, который таблица использует: плохой (тождественный std::hash для чисел) перемешивается
+template <class Hash> constexpr std::size_t finalize_hash(std::size_t h) noexcept {
+	if constexpr (is_avalanching_v<Hash>) {
+		return h;
+	} else {
+		return static_cast<std::size_t>(mix64(h));
+	}
+}
+} // namespace detail
+
+constexpr std::size_t hash_bytes(std::string_view bytes, std::uint64_t seed = 0) noexcept {
+	return static_cast<std::size_t>(detail::hash_bytes(bytes.data(), bytes.size(), seed));
+}
+inline std::size_t hash_bytes(std::span<const std::byte> bytes, std::uint64_t seed = 0) noexcept {
+	return static_cast<std::size_t>(detail::hash_bytes(bytes.data(), bytes.size(), seed));
+}
+
+// хеши для таблиц libtech: все лавинные, так что таблица не перемешивает их еще раз.
+// Для остальных типов берется std::hash и перемешивается
+template <class Key> struct Hash {
+	using is_avalanching = void;
+	std::size_t operator()(const Key& key) const noexcept(noexcept(std::hash<Key>{}(key))) {
+		return static_cast<std::size_t>(detail::mix64(std::hash<Key>{}(key)));
+	}
+};
+template <class Key>
+	requires(std::is_integral_v<Key> || std::is_enum_v<Key> || std::is_pointer_v<Key>)
+struct Hash<Key> {
+	using is_avalanching = void;
+	constexpr std::size_t operator()(Key key) const noexcept {
+		if constexpr (std::is_pointer_v<Key>) {
+			return static_cast<std::size_t>(detail::mix64(reinterpret_cast<std::uintptr_t>(key)));
+		} else if constexpr (std::is_enum_v<Key>) {
+			return static_cast<std::size_t>(detail::mix64(static_cast<std::uint64_t>(static_cast<std::underlying_type_t<Key>>(key))));
+		} else {
+			return static_cast<std::size_t>(detail::mix64(static_cast<std::uint64_t>(key)));
+		}
+	}
+};
+template <class Key>
+	requires std::is_floating_point_v<Key>
+struct Hash<Key> {
+	using is_avalanching = void;
+	std::size_t operator()(Key key) const noexcept {
+		// -0.0 == 0.0, хеши должны совпасть
+		if (key == Key(0)) {
+			return static_cast<std::size_t>(detail::mix64(0));
+		}
+		if constexpr (sizeof(Key) == sizeof(std::uint64_t)) {
+			return static_cast<std::size_t>(detail::mix64(std::bit_cast<std::uint64_t>(key)));
+		} else if constexpr (sizeof(Key) == sizeof(std::uint32_t)) {
+			return static_cast<std::size_t>(detail::mix64(std::bit_cast<std::uint32_t>(key)));
+		} else {
+			return static_cast<std::size_t>(detail::mix64(std::hash<Key>{}(key)));
+		}
+	}
+};
+// строки хешируются по содержимому, поиск по std::string_view и const char* без временной строки
+struct StringHash {
+	using is_transparent = void;
+	using is_avalanching = void;
+	constexpr std::size_t operator()(std::string_view str) const noexcept { return hash_bytes(str); }
+};
+template <> struct Hash<std::string> : StringHash {};
+template <> struct Hash<std::string_view> : StringHash {};
+} // namespace tech
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <libtech/growth_policy.hpp>
+#include <libtech/hash.hpp>
+#include <libtech/hash_table.hpp>
+#include <libtech/hash_traits.hpp>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace tech {
+// карта с повторяющимися ключами на ChainedTable, том же движке, что у HashMap: каждое значение в своей ноде,
+// равные ключи в ведре подряд, так что equal_range - одна серия без отдельного вектора на ключ
+template <class Key, class T, class Hash = tech::Hash<Key>, class KeyEqual = std::equal_to<Key>, class Allocator = std::allocator<std::pair<Key, T>>, class GrowthPolicy = PrimeGrowthPolicy<>>
+class HashMultiMap : private detail::ChainedTable<std::pair<Key, T>, detail::MapKey, Key, Hash, KeyEqual, Allocator, GrowthPolicy, false> {
+	using table = detail::ChainedTable<std::pair<Key, T>, detail::MapKey, Key, Hash, KeyEqual, Allocator, GrowthPolicy, false>;
+
+  public:
+	using typename table::size_type;
+	using typename table::value_type;
+	using typename table::key_type;
+	using mapped_type = T;
+	using typename table::hasher;
+	using typename table::key_equal;
+	using typename table::allocator_type;
+	using typename table::node_type;
+	using growth_policy = GrowthPolicy;
+	using typename table::iterator;
+	using typename table::const_iterator;
+
+	/* constructors */
+	HashMultiMap() : table() {}
+	explicit HashMultiMap(const Allocator& alloc) : table(1, Hash(), KeyEqual(), alloc) {}
+	explicit HashMultiMap(size_type buckets_count, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: table(buckets_count, _hash, _equal, alloc) {}
+	template <class InputIt>
+	HashMultiMap(InputIt first, InputIt last, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: table(buckets_count, _hash, _equal, alloc) {
+		insert(first, last);
+	}
+	HashMultiMap(std::initializer_list<value_type> init, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: HashMultiMap(init.begin(), init.end(), buckets_count, _hash, _equal, alloc) {}
+
+	using table::get_allocator;
+
+	/* iterators */
+	using table::begin;
+	using table::end;
+	using table::cbegin;
+	using table::cend;
+
+	/* capacity */
+	using table::empty;
+	using table::size;
+
+	/* modifiers */
+	using table::clear;
+	iterator insert(const value_type& value) { return emplace(value); }
+	iterator insert(value_type&& value) { return emplace(std::move(value)); }
+	template <class InputIt> void insert(InputIt first, InputIt last) {
+		for (auto it = first; it != last; ++it) {
+			emplace(*it);
+		}
+	}
+	void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+	// новый элемент встает за первым с тем же ключом, порядок внутри серии не гарантируется
+	template <class... Args> iterator emplace(Args&&... args) {
+		return table::emplace_equal(std::forward<Args>(args)...);
+	}
+	iterator erase(iterator pos) { return table::erase(pos); }
+	iterator erase(const_iterator pos) { return table::erase(pos); }
+	// удаляет всю серию, возвращает сколько удалено
+	size_type erase(const Key& key) { return table::erase_key(key); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual> &&
+		(!std::is_convertible_v<K, iterator>) && (!std::is_convertible_v<K, const_iterator>)
+	size_type erase(const K& key) { return table::erase_key(key); }
+
+	/* lookup */
+	iterator find(const Key& key) { return table::find(key); }
+	const_iterator find(const Key& key) const { return table::find(key); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	iterator find(const K& key) { return table::find(key); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	const_iterator find(const K& key) const { return table::find(key); }
+	bool contains(const Key& key) const { return table::contains(key); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	bool contains(const K& key) const { return table::contains(key); }
+	size_type count(const Key& key) const { return table::count(key); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	size_type count(const K& key) const { return table::count(key); }
+	std::pair<iterator, iterator> equal_range(const Key& key) { return table::equal_range(key); }
+	std::pair<const_iterator, const_iterator> equal_range(const Key& key) const { return table::equal_range(key); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	std::pair<iterator, iterator> equal_range(const K& key) { return table::equal_range(key); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	std::pair<const_iterator, const_iterator> equal_range(const K& key) const { return table::equal_range(key); }
+
+	/* bucket interface */
+	using table::bucket_count;
+	using table::bucket_size;
+
+	/* hash policy */
+	using table::load_factor;
+	using table::max_load_factor;
+	using table::rehash;
+	using table::reserve;
+
+	/* observers */
+	using table::hash_function;
+	using table::key_eq;
+};
+} // namespace tech
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <libtech/growth_policy.hpp>
+#include <libtech/hash.hpp>
+#include <libtech/hash_table.hpp>
+#include <libtech/hash_traits.hpp>
+#include <memory>
+#include <utility>
+
+namespace tech {
+// множество на ChainedTable, том же движке, что у HashMap: в ноде только ключ (и хеш, если он кешируется),
+// без лишнего mapped_type. Элементы не меняются через итератор, как в std::unordered_set
+template <class Key, class Hash = tech::Hash<Key>, class KeyEqual = std::equal_to<Key>, class Allocator = std::allocator<Key>, class GrowthPolicy = PrimeGrowthPolicy<>>
+class HashSet : private detail::ChainedTable<Key, detail::SetKey, Key, Hash, KeyEqual, Allocator, GrowthPolicy, true> {
+	using table = detail::ChainedTable<Key, detail::SetKey, Key, Hash, KeyEqual, Allocator, GrowthPolicy, true>;
+
+  public:
+	using typename table::size_type;
+	using typename table::value_type;
+	using typename table::key_type;
+	using typename table::hasher;
+	using typename table::key_equal;
+	using typename table::allocator_type;
+	using typename table::node_type;
+	using growth_policy = GrowthPolicy;
+	using iterator = typename table::const_iterator;
+	using const_iterator = typename table::const_iterator;
+
+	/* constructors */
+	HashSet() : table() {}
+	explicit HashSet(const Allocator& alloc) : table(1, Hash(), KeyEqual(), alloc) {}
+	explicit HashSet(size_type buckets_count, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: table(buckets_count, _hash, _equal, alloc) {}
+	template <class InputIt>
+	HashSet(InputIt first, InputIt last, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: table(buckets_count, _hash, _equal, alloc) {
+		insert(first, last);
+	}
+	HashSet(std::initializer_list<value_type> init, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: HashSet(init.begin(), init.end(), buckets_count, _hash, _equal, alloc) {}
+
+	using table::get_allocator;
+
+	/* iterators */
+	const_iterator begin() const noexcept { return table::begin(); }
+	const_iterator end() const noexcept { return table::end(); }
+	const_iterator cbegin() const noexcept { return table::begin(); }
+	const_iterator cend() const noexcept { return table::end(); }
+
+	/* capacity */
+	using table::empty;
+	using table::size;
+
+	/* modifiers */
+	using table::clear;
+	std::pair<iterator, bool> insert(const value_type& value) { return emplace(value); }
+	std::pair<iterator, bool> insert(value_type&& value) { return emplace(std::move(value)); }
+	template <class InputIt> void insert(InputIt first, InputIt last) {
+		for (auto it = first; it != last; ++it) {
+			emplace(*it);
+		}
+	}
+	void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+	template <class... Args> std::pair<iterator, bool> emplace(Args&&... args) {
+		return table::emplace_unique(std::forward<Args>(args)...);
+	}
+	iterator erase(const_iterator pos) { return table::erase(pos); }
+	size_type erase(const Key& key) { return table::erase_key(key); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	size_type erase(const K& key) { return table::erase_key(key); }
+
+	/* lookup */
+	const_iterator find(const Key& key) const { return table::find(key); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	const_iterator find(const K& key) const { return table::find(key); }
+	bool contains(const Key& key) const { return table::contains(key); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	bool contains(const K& key) const { return table::contains(key); }
+	size_type count(const Key& key) const { return table::contains(key) ? 1 : 0; }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	size_type count(const K& key) const { return table::contains(key) ? 1 : 0; }
+
+	/* bucket interface */
+	using table::bucket_count;
+	using table::bucket_size;
+
+	/* hash policy */
+	using table::load_factor;
+	using table::max_load_factor;
+	using table::rehash;
+	using table::reserve;
+
+	/* observers */
+	using table::hash_function;
+	using table::key_eq;
+
+	bool operator==(const HashSet& other) const {
+		if (size() != other.size()) {
+			return false;
+		}
+		for (const auto& key : *this) {
+			if (!other.contains(key)) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+} // namespace tech
@@ -0,0 +1,715 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <libtech/bucket_bitmap.hpp>
+#include <libtech/execution.hpp>
+#include <libtech/forward_list.hpp>
+#include <libtech/growth_policy.hpp>
+#include <libtech/hash.hpp>
+#include <libtech/hash_traits.hpp>
+#include <libtech/stats_policy.hpp>
+#include <libtech/vector.hpp>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tech {
+namespace detail {
+// ключ хранимого значения: у множества это само значение, у карты - first
+struct SetKey {
+	template <class V> static const V& get(const V& value) noexcept { return value; }
+};
+struct MapKey {
+	template <class V> static const auto& get(const V& value) noexcept { return value.first; }
+};
+
+// ключ из аргументов emplace без постройки ноды: у множества - единственный аргумент типа Key
+template <class KeyOf, class Key, class... Args> struct table_key_extractor : key_extractor<Key, Args...> {};
+template <class Key, class Arg> struct table_key_extractor<SetKey, Key, Arg> : std::is_same<Arg, Key> {
+	static const Key& get(const Key& key) { return key; }
+};
+template <class KeyOf, class Key, class... Args>
+using table_key_extractor_for = table_key_extractor<KeyOf, Key, std::remove_cvref_t<Args>...>;
+
+// цепочечная таблица - общий движок HashMap, HashSet и HashMultiMap: ведра, битмап непустых ведер,
+// обход, rehash (в том числе параллельный) и статистика. Ключ берется из значения через KeyOf.
+// UniqueKeys - ключ не повторяется (emplace_unique), иначе равные ключи лежат в ведре подряд (emplace_equal)
+template <class Value, class KeyOf, class Key, class Hash, class KeyEqual, class Allocator, class GrowthPolicy,
+		  bool UniqueKeys, class StatsPolicy = NoStatsPolicy>
+class ChainedTable {
+  public:
+	using size_type = std::size_t;
+	using value_type = Value;
+	using key_type = Key;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using allocator_type = Allocator;
+	using bucket_type = ForwardList<Value, Allocator, cache_hash_code_v<Key, Hash>>;
+	using buckets_type = Vector<bucket_type, typename std::allocator_traits<Allocator>::template rebind_alloc<bucket_type>>;
+	using node_type = typename bucket_type::node_type;
+	using growth_policy = GrowthPolicy;
+	using stats_policy_type = StatsPolicy;
+
+  protected:
+	static constexpr const std::size_t INIT_BUCKET_COUNT = 1;
+	static constexpr const float DEFAULT_MAX_LOAD_FACTOR = 1;
+	using node_allocator = typename bucket_type::node_allocator;
+	using node_traits = std::allocator_traits<node_allocator>;
+	[[no_unique_address]] node_allocator node_alloc;
+	buckets_type buckets;
+	// непустые ведра и первое из них: begin() за O(1), обход не смотрит пустые ведра
+	BucketBitmap<Allocator> occupied;
+	size_type first_occupied = 0;
+	Hash hash;
+	[[no_unique_address]] KeyEqual equal;
+	GrowthPolicy policy;
+	size_type items_count = 0;
+	// разных ключей, только при повторяющихся ключах: заполнение считается по ним, серия равных
+	// ключей - одна запись цепочки. Так у HashMultiMap ведер столько, сколько групп, а не элементов
+	size_type keys_count = 0;
+	float max_saturation = DEFAULT_MAX_LOAD_FACTOR;
+	// копия и перемещение таблицы счетчики не переносят
+	[[no_unique_address]] StatsPolicy stats_policy;
+
+  public:
+	template <class ValueType, class TableType> class Iterator {
+	  public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = ValueType;
+		using pointer = ValueType*;
+		using reference = ValueType&;
+		using iterator_category = std::forward_iterator_tag;
+		friend class ChainedTable;
+
+	  private:
+		TableType* table;
+		ValueType* current;
+		decltype(table->buckets.end()) bucket_iterator;
+		decltype(bucket_iterator->begin()) list_iterator;
+
+	  public:
+		Iterator() : Iterator(static_cast<TableType*>(nullptr)) {}
+		Iterator(TableType* ptr) : table(ptr), current(nullptr), bucket_iterator(nullptr), list_iterator(nullptr) {
+			if (table == nullptr || table->first_occupied == table->bucket_count()) {
+				return;
+			}
+			bucket_iterator = table->buckets.begin();
+			bucket_iterator += table->first_occupied;
+			list_iterator = bucket_iterator->begin();
+			current = &(*list_iterator);
+		}
+		Iterator(TableType* ptr, decltype(bucket_iterator) bucket, node_type* node)
+			: table(ptr), bucket_iterator(bucket), list_iterator(node) {
+			current = &(*list_iterator);
+		}
+		// iterator приводится к const_iterator
+		operator Iterator<const Value, const ChainedTable>() const requires(!std::is_const_v<TableType>) {
+			if (!current) {
+				return {};
+			}
+			auto bucket = bucket_iterator;
+			return {table, &*bucket, list_iterator.current};
+		}
+		reference operator*() const { return *current; }
+		pointer operator->() const { return current; }
+		bool operator==(const Iterator& another) const { return current == another.current; }
+		Iterator& operator++() {
+			if (current) {
+				if (++list_iterator == bucket_iterator->end()) {
+					// следующее непустое ведро берем из битмапа
+					auto index = static_cast<size_type>(bucket_iterator - table->buckets.begin());
+					auto next = table->occupied.find_next(index + 1);
+					if (next == table->bucket_count()) {
+						current = nullptr;
+						return *this;
+					}
+					bucket_iterator += static_cast<std::ptrdiff_t>(next - index);
+					list_iterator = bucket_iterator->begin();
+				}
+				current = &(*list_iterator);
+			}
+			return *this;
+		}
+		Iterator operator++(int) {
+			auto old = *this;
+			++(*this);
+			return old;
+		}
+	};
+	using iterator = Iterator<Value, ChainedTable>;
+	using const_iterator = Iterator<const Value, const ChainedTable>;
+
+	// элементы ведер [first, last) из bucket_range: соседние диапазоны не пересекаются
+	// и вместе дают всю таблицу, так что их можно раздать разным потокам
+	template <class IteratorType> class BucketRange {
+	  public:
+		IteratorType begin() const { return first; }
+		IteratorType end() const { return last; }
+		bool empty() const { return first == last; }
+
+	  private:
+		friend class ChainedTable;
+		BucketRange(IteratorType _first, IteratorType _last) : first(_first), last(_last) {}
+		IteratorType first;
+		IteratorType last;
+	};
+	using bucket_range_type = BucketRange<iterator>;
+	using const_bucket_range_type = BucketRange<const_iterator>;
+
+	/* constructors */
+	explicit ChainedTable(size_type buckets_count = INIT_BUCKET_COUNT, const Hash& _hash = Hash(),
+						  const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: node_alloc(alloc), buckets(node_alloc), occupied(node_alloc), hash(_hash), equal(_equal) {
+		init_buckets(buckets_count);
+	}
+
+	/* rule of 5 */
+	ChainedTable(const ChainedTable& other)
+		: node_alloc(node_traits::select_on_container_copy_construction(other.node_alloc)), buckets(node_alloc),
+		  occupied(node_alloc), hash(other.hash), equal(other.equal), max_saturation(other.max_saturation) {
+		copy_from(other);
+	}
+	ChainedTable(ChainedTable&& other) noexcept
+		: node_alloc(std::move(other.node_alloc)), buckets(std::move(other.buckets)),
+		  occupied(std::move(other.occupied)), first_occupied(std::exchange(other.first_occupied, 0)),
+		  hash(std::move(other.hash)), equal(other.equal), policy(other.policy),
+		  items_count(std::exchange(other.items_count, 0)), keys_count(std::exchange(other.keys_count, 0)),
+		  max_saturation(other.max_saturation) {
+		// перемещенная таблица остается без ведер: поиск и begin() это учитывают,
+		// первая вставка выделит ведра заново
+	}
+	ChainedTable& operator=(const ChainedTable& other) {
+		if (this == &other) {
+			return *this;
+		}
+		clear();
+		if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+			node_alloc = other.node_alloc;
+		}
+		hash = other.hash;
+		equal = other.equal;
+		max_saturation = other.max_saturation;
+		copy_from(other);
+		return *this;
+	}
+	ChainedTable& operator=(ChainedTable&& other) {
+		if (this == &other) {
+			return *this;
+		}
+		hash = std::move(other.hash);
+		equal = other.equal;
+		max_saturation = other.max_saturation;
+		if constexpr (!node_traits::propagate_on_container_move_assignment::value) {
+			if (node_alloc != other.node_alloc) {
+				// ноды чужого аллокатора забрать нельзя, переносим значения
+				clear();
+				init_buckets(other.bucket_count());
+				for (auto& value : other) {
+					if constexpr (UniqueKeys) {
+						auto* node = new_node(std::move(value));
+						insert_new_node(node, hash_of(KeyOf::get(node->value)));
+					} else {
+						emplace_equal(std::move(value));
+					}
+				}
+				other.clear();
+				return *this;
+			}
+		} else {
+			node_alloc = other.node_alloc;
+		}
+		clear();
+		buckets = std::move(other.buckets);
+		occupied = std::move(other.occupied);
+		first_occupied = std::exchange(other.first_occupied, 0);
+		policy = other.policy;
+		items_count = std::exchange(other.items_count, 0);
+		keys_count = std::exchange(other.keys_count, 0);
+		return *this;
+	}
+	~ChainedTable() = default;
+
+	allocator_type get_allocator() const noexcept { return allocator_type(node_alloc); }
+
+	/* iterators */
+	iterator begin() noexcept { return iterator(this); }
+	iterator end() noexcept { return iterator(static_cast<ChainedTable*>(nullptr)); }
+	const_iterator begin() const noexcept { return const_iterator(this); }
+	const_iterator end() const noexcept { return const_iterator(static_cast<const ChainedTable*>(nullptr)); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+
+	/* capacity */
+	size_type size() const noexcept { return items_count; }
+	bool empty() const noexcept { return size() == 0; }
+
+	/* modifiers */
+	void clear() noexcept {
+		// чистим только непустые ведра
+		for (auto i = first_occupied; i < bucket_count(); i = occupied.find_next(i + 1)) {
+			buckets[i].clear();
+			occupied.clear(i);
+		}
+		first_occupied = bucket_count();
+		items_count = 0;
+		keys_count = 0;
+	}
+	// ноды освобождаются несколькими потоками, каждый на своем диапазоне ведер.
+	// Только для аллокатора, которому можно освобождать из нескольких потоков
+	template <class ExecutionPolicy> requires execution::is_execution_policy_v<ExecutionPolicy>
+	void clear(ExecutionPolicy&& exec) noexcept {
+		auto parts = parts_for(exec, size());
+		if (!is_concurrent_allocator<Allocator>::value || parts == 1) {
+			clear();
+			return;
+		}
+		run_parts_nothrow(parts, bucket_count(), [&](std::size_t /*part*/, std::size_t begin, std::size_t end) {
+			for (auto i = occupied.find_next(begin); i < end; i = occupied.find_next(i + 1)) {
+				buckets[i].clear();
+			}
+		});
+		occupied.clear_all();
+		first_occupied = bucket_count();
+		items_count = 0;
+		keys_count = 0;
+	}
+	// вставка, если ключа нет. Если ключ виден в аргументах, нода для повтора не создается
+	template <class... Args> std::pair<iterator, bool> emplace_unique(Args&&... args) {
+		using extractor = table_key_extractor_for<KeyOf, Key, Args...>;
+		if constexpr (extractor::value) {
+			const Key& key = extractor::get(args...);
+			auto h = hash_of(key);
+			if (auto* found = lookup(key, h)) {
+				return {iterator(this, &buckets[bucket_index(h)], found), false};
+			}
+			auto* node = new_node(std::forward<Args>(args)...);
+			return {insert_new_node(node, h), true};
+		} else {
+			// создать элемент, проверить есть ли с таким ключом, если есть уничтожить созданный, если нет вставить
+			auto* node = new_node(std::forward<Args>(args)...);
+			auto h = hash_of(KeyOf::get(node->value));
+			if (auto* found = lookup(KeyOf::get(node->value), h)) {
+				bucket_type::destroy_node(node_alloc, node);
+				return {iterator(this, &buckets[bucket_index(h)], found), false};
+			}
+			return {insert_new_node(node, h), true};
+		}
+	}
+	// вставка всегда: за первым равным ключом в ведре, иначе в начало ведра
+	template <class... Args> iterator emplace_equal(Args&&... args) requires(!UniqueKeys) {
+		auto* node = new_node(std::forward<Args>(args)...);
+		auto h = hash_of(KeyOf::get(node->value));
+		if (auto* same = lookup(KeyOf::get(node->value), h)) {
+			// серия равных ключей не растягивает цепочку по заполнению, rehash не нужен
+			auto index = bucket_index(h);
+			node->hash_code.set(h);
+			buckets[index].insert_after(same, node);
+			++items_count;
+			return iterator(this, &buckets[index], node);
+		}
+		return insert_new_node(node, h);
+	}
+	template <class It> iterator erase(It pos) {
+		if (pos == It()) {
+			return end();
+		}
+		auto next = std::next(pos);
+		bucket_type::destroy_node(node_alloc, unlink_at(pos));
+		if (next == It()) {
+			return end();
+		}
+		return iterator(this, &buckets[bucket_of(next)], next.list_iterator.current);
+	}
+	// удаляет все элементы с ключом key, возвращает сколько удалено
+	template <class K> size_type erase_key(const K& key) {
+		auto h = hash_of(key);
+		auto* first = lookup(key, h);
+		if (!first) {
+			return 0;
+		}
+		if constexpr (UniqueKeys) {
+			destroy_run(bucket_index(h), first, 1);
+			return 1;
+		} else {
+			// длина серии считается до удаления: key может ссылаться на ключ в одной из нод
+			auto count = run_length(first, key, h);
+			destroy_run(bucket_index(h), first, count);
+			return count;
+		}
+	}
+
+	/* lookup */
+	template <class K> iterator find(const K& key) { return find_impl(*this, key); }
+	template <class K> const_iterator find(const K& key) const { return find_impl(*this, key); }
+	template <class K> size_type count(const K& key) const {
+		auto h = hash_of(key);
+		auto* first = lookup(key, h);
+		if constexpr (UniqueKeys) {
+			return first ? 1 : 0;
+		} else {
+			return first ? run_length(first, key, h) : 0;
+		}
+	}
+	template <class K> bool contains(const K& key) const { return lookup(key, hash_of(key)) != nullptr; }
+	template <class K> std::pair<iterator, iterator> equal_range(const K& key) { return equal_range_impl(*this, key); }
+	template <class K> std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+		return equal_range_impl(*this, key);
+	}
+	// через него идет любой поиск ключа, включая вставки, erase, extract и merge: здесь и считается on_lookup
+	template <class K> node_type* find_node(const bucket_type& bucket, const K& key, std::size_t h) const {
+		for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+			if (node_matches(it.current, key, h)) {
+				stats_policy.on_lookup(true);
+				return it.current;
+			}
+		}
+		stats_policy.on_lookup(false);
+		return nullptr;
+	}
+
+	/* bucket interface */
+	size_type bucket_count() const { return buckets.size(); }
+	size_type bucket_size(size_type n) const { return buckets[n].size(); }
+	std::size_t bucket_index(std::size_t h) const { return policy.index(h); }
+	// пустые ведра пропускаются по битмапу. Диапазон живет до вставки с rehash, erase и clear
+	bucket_range_type bucket_range(size_type first, size_type last) { return bucket_range_impl(*this, first, last); }
+	const_bucket_range_type bucket_range(size_type first, size_type last) const {
+		return bucket_range_impl(*this, first, last);
+	}
+
+	/* hash policy */
+	// разных ключей на ведро, при уникальных ключах это size() / bucket_count()
+	float load_factor() const { return bucket_count() == 0 ? 0 : static_cast<float>(key_count()) / bucket_count(); }
+	void rehash(size_type count) { rehash(execution::seq, count); }
+	// с execution::par старые ведра делятся между потоками, ноды раскладываются
+	// по полосам новых ведер и каждая полоса собирается своим потоком
+	template <class ExecutionPolicy> requires execution::is_execution_policy_v<ExecutionPolicy>
+	void rehash(ExecutionPolicy&& exec, size_type count) {
+		count = std::max<size_type>(count, std::ceil(key_count() / max_load_factor()));
+		count = GrowthPolicy::bucket_count_for(count);
+		if (count == bucket_count()) {
+			return;
+		}
+		stats_policy.timed_rehash([&] {
+			auto parts = parts_for(exec, size());
+			// новые ведра и битмап выделяются до того, как трогать старые: если выделение бросит,
+			// таблица остается как была. Дальше ноды только перецепляются, это не бросает
+			auto new_buckets = make_buckets(count);
+			auto new_occupied = make_bitmap(count);
+			auto old_buckets = std::exchange(buckets, std::move(new_buckets));
+			auto old_occupied = std::exchange(occupied, std::move(new_occupied));
+			auto old_first = std::exchange(first_occupied, count);
+			policy.reset(count);
+			if (parts > 1) {
+				relink_parallel(parts, old_buckets, old_occupied);
+				return;
+			}
+			// серия равных ключей переносится подряд и в новом ведре остается серией
+			for (auto i = old_first; i < old_buckets.size(); i = old_occupied.find_next(i + 1)) {
+				auto& bucket = old_buckets[i];
+				while (!bucket.empty()) {
+					auto* node = bucket.release_front();
+					push_node(bucket_index(node_hash(node)), node);
+				}
+			}
+		});
+	}
+	void reserve(size_type count) { rehash(std::ceil(count / max_load_factor())); }
+	void max_load_factor(float lf) {
+		max_saturation = lf;
+		if (load_factor() > max_saturation) {
+			reserve(key_count());
+		}
+	}
+	float max_load_factor() const { return max_saturation; }
+
+	/* observers */
+	Hash hash_function() const { return hash; }
+	KeyEqual key_eq() const { return equal; }
+
+	/* statistics */
+	// счетчики StatsPolicy (с NoStatsPolicy нули) и форма таблицы: длины цепочек за O(bucket_count)
+	HashMapStats stats() const {
+		HashMapStats result;
+		stats_policy.fill(result);
+		result.size = size();
+		result.bucket_count = bucket_count();
+		result.load_factor = load_factor();
+		result.max_load_factor = max_load_factor();
+		result.chain_lengths[0] = bucket_count();
+		for (auto i = first_occupied; i < bucket_count(); i = occupied.find_next(i + 1)) {
+			auto length = bucket_size(i);
+			result.max_chain = std::max(result.max_chain, length);
+			--result.chain_lengths[0];
+			++result.chain_lengths[std::min(length, HashMapStats::CHAIN_HISTOGRAM_SIZE - 1)];
+		}
+		return result;
+	}
+	void dump_stats(std::ostream& out) const { tech::dump_stats(out, stats()); }
+
+  protected:
+	size_type key_count() const noexcept {
+		if constexpr (UniqueKeys) {
+			return items_count;
+		} else {
+			return keys_count;
+		}
+	}
+	// все хеши таблицы идут через него: std::hash<int> (тождественный) перемешивается, лавинный берется как есть
+	template <class K> std::size_t hash_of(const K& key) const { return finalize_hash<Hash>(hash(key)); }
+	std::size_t node_hash(const node_type* node) const {
+		if constexpr (cache_hash_code_v<Key, Hash>) {
+			return node->hash_code.value;
+		} else {
+			return hash_of(KeyOf::get(node->value));
+		}
+	}
+	// хеш ноды другой таблицы: кеш годится, только если хешеры не отличаются, то есть Hash без состояния
+	std::size_t foreign_hash(const node_type* node) const {
+		if constexpr (std::is_empty_v<Hash>) {
+			return node_hash(node);
+		} else {
+			return hash_of(KeyOf::get(node->value));
+		}
+	}
+	// ведер нет только у перемещенной таблицы, в ней ничего не найти
+	template <class K> node_type* lookup(const K& key, std::size_t h) const {
+		if (bucket_count() == 0) {
+			stats_policy.on_lookup(false);
+			return nullptr;
+		}
+		return find_node(buckets[bucket_index(h)], key, h);
+	}
+	template <class... Args> node_type* new_node(Args&&... args) {
+		auto* node = bucket_type::create_node(node_alloc, std::forward<Args>(args)...);
+		stats_policy.on_allocate(sizeof(node_type));
+		return node;
+	}
+	void push_node(size_type index, node_type* node) {
+		buckets[index].push_front(node);
+		occupied.set(index);
+		first_occupied = std::min(first_occupied, index);
+	}
+	// нода только что создана: если рост таблицы бросит, ее больше некому освободить
+	iterator insert_new_node(node_type* node, std::size_t h) {
+		try {
+			return insert_node(node, h);
+		} catch (...) {
+			bucket_type::destroy_node(node_alloc, node);
+			throw;
+		}
+	}
+	// ключа точно нет, хеш уже посчитан. Если rehash бросит, нода остается у вызывающего
+	iterator insert_node(node_type* node, std::size_t h) {
+		if (key_count() + 1 > max_load_factor() * bucket_count()) {
+			rehash(policy.next_bucket_count(bucket_count()));
+		}
+		auto index = bucket_index(h);
+		node->hash_code.set(h);
+		push_node(index, node);
+		++items_count;
+		if constexpr (!UniqueKeys) {
+			++keys_count;
+		}
+		return iterator(this, &buckets[index], node);
+	}
+	// нода вынимается из ведра, освобождает вызывающий
+	void unlink_node(size_type index, node_type* node) {
+		if constexpr (!UniqueKeys) {
+			// последний элемент своей серии уносит и ключ
+			keys_count -= count_in_bucket(buckets[index], KeyOf::get(node->value), node_hash(node)) == 1 ? 1 : 0;
+		}
+		buckets[index].release(node);
+		--items_count;
+		bucket_emptied(index);
+	}
+	template <class It> node_type* unlink_at(It pos) {
+		auto* node = pos.list_iterator.current;
+		unlink_node(bucket_of(pos), node);
+		return node;
+	}
+	template <class It> size_type bucket_of(It pos) const {
+		return static_cast<size_type>(&*pos.bucket_iterator - buckets.data());
+	}
+	// ведро могло опустеть после удаления
+	void bucket_emptied(size_type index) {
+		if (!buckets[index].empty()) {
+			return;
+		}
+		occupied.clear(index);
+		if (index == first_occupied) {
+			first_occupied = occupied.find_next(index + 1);
+		}
+	}
+
+  private:
+	template <class K> bool node_matches(const node_type* node, const K& key, std::size_t h) const {
+		// при закешированном хеше ключ сравнивается только при совпадении хешей
+		return node->hash_code.matches(h) && equal(KeyOf::get(node->value), key);
+	}
+	template <class K> size_type run_length(const node_type* first, const K& key, std::size_t h) const {
+		size_type count = 1;
+		for (auto* node = first->next; node && node_matches(node, key, h); node = node->next) {
+			++count;
+		}
+		return count;
+	}
+	template <class K> size_type count_in_bucket(const bucket_type& bucket, const K& key, std::size_t h) const {
+		size_type count = 0;
+		for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+			count += node_matches(it.current, key, h) ? 1 : 0;
+		}
+		return count;
+	}
+	// общий find для const и не const таблицы: хешируем один раз и смотрим только в одно ведро
+	template <class Self, class K> static auto find_impl(Self& self, const K& key) -> decltype(self.end()) {
+		auto h = self.hash_of(key);
+		auto* node = self.lookup(key, h);
+		if (!node) {
+			return self.end();
+		}
+		return decltype(self.end())(&self, &self.buckets[self.bucket_index(h)], node);
+	}
+	template <class Self, class K>
+	static auto equal_range_impl(Self& self, const K& key) -> std::pair<decltype(self.end()), decltype(self.end())> {
+		using range_iterator = decltype(self.end());
+		auto h = self.hash_of(key);
+		auto* first = self.lookup(key, h);
+		if (!first) {
+			return {self.end(), self.end()};
+		}
+		auto& bucket = self.buckets[self.bucket_index(h)];
+		auto* last = first;
+		while (last->next && self.node_matches(last->next, key, h)) {
+			last = last->next;
+		}
+		range_iterator after(&self, &bucket, last);
+		return {range_iterator(&self, &bucket, first), ++after};
+	}
+	// границы - первые элементы первого непустого ведра с first и с last, конец таблицы - end()
+	template <class Self> static auto bucket_range_impl(Self& self, size_type first, size_type last) {
+		using range_iterator = decltype(self.end());
+		last = std::min(last, self.bucket_count());
+		auto at = [&](size_type index) {
+			if (index >= self.bucket_count()) {
+				return self.end();
+			}
+			auto& bucket = self.buckets[index];
+			return range_iterator(&self, &bucket, bucket.begin().current);
+		};
+		auto begin_index = first < last ? self.occupied.find_next(first) : last;
+		if (begin_index >= last) {
+			return BucketRange<range_iterator>(self.end(), self.end());
+		}
+		return BucketRange<range_iterator>(at(begin_index), at(self.occupied.find_next(last)));
+	}
+
+	buckets_type make_buckets(size_type count) {
+		buckets_type new_buckets(count, node_alloc);
+		stats_policy.on_allocate(count * sizeof(bucket_type));
+		for (size_type i = 0; i < count; ++i) {
+			new_buckets.emplace_back(allocator_type(node_alloc));
+		}
+		return new_buckets;
+	}
+	BucketBitmap<Allocator> make_bitmap(size_type count) {
+		using bitmap_type = BucketBitmap<Allocator>;
+		bitmap_type bitmap(node_alloc);
+		bitmap.reset(count);
+		stats_policy.on_allocate((count + bitmap_type::WORD_BITS - 1) / bitmap_type::WORD_BITS * sizeof(typename bitmap_type::word_type));
+		return bitmap;
+	}
+	void init_buckets(size_type count) {
+		count = GrowthPolicy::bucket_count_for(count);
+		buckets = make_buckets(count);
+		occupied = make_bitmap(count);
+		first_occupied = count;
+		policy.reset(count);
+	}
+	// count нод подряд, начиная с first: одна серия, ключ уходит вместе с ней
+	void destroy_run(size_type index, node_type* first, size_type count) noexcept {
+		auto& bucket = buckets[index];
+		items_count -= count;
+		if constexpr (!UniqueKeys) {
+			--keys_count;
+		}
+		for (auto* node = first; count != 0; --count) {
+			auto* next = node->next;
+			bucket_type::destroy_node(node_alloc, bucket.release(node));
+			node = next;
+		}
+		bucket_emptied(index);
+	}
+	void copy_from(const ChainedTable& other) {
+		// раскладка по ведрам та же, так что хеши не пересчитываем
+		init_buckets(other.bucket_count());
+		for (auto i = other.first_occupied; i < other.bucket_count(); i = other.occupied.find_next(i + 1)) {
+			for (auto it = other.buckets[i].begin(); it != other.buckets[i].end(); ++it) {
+				auto* node = new_node(*it);
+				node->hash_code = it.current->hash_code;
+				push_node(i, node);
+			}
+		}
+		items_count = other.items_count;
+		keys_count = other.keys_count;
+	}
+	// rehash в parts потоков. Сначала каждый поток снимает ноды со своего диапазона старых ведер
+	// и цепляет их через next в свои списки по полосам новых ведер (полоса кратна 64 ведрам,
+	// чтобы потоки не делили слова битмапа), затем каждая полоса собирается одним потоком. Ни блокировок,
+	// ни атомарных операций: каждое ведро и слово битмапа пишет ровно один поток.
+	// Старое ведро целиком у одного потока, так что серия равных ключей и здесь остается подряд
+	void relink_parallel(std::size_t parts, buckets_type& old_buckets, BucketBitmap<Allocator>& old_occupied) {
+		const size_type word = BucketBitmap<Allocator>::WORD_BITS;
+		const size_type stripe = std::max<size_type>((bucket_count() / parts + word - 1) / word * word, word);
+		const size_type stripes = (bucket_count() + stripe - 1) / stripe;
+		std::vector<node_type*> staged;
+		try {
+			staged.assign(parts * stripes, nullptr);
+		} catch (...) {
+			// без памяти под списки переносим в одном потоке, rehash не должен терять ноды
+			parts = 1;
+		}
+		auto unlink = [&](std::size_t part, std::size_t begin, std::size_t end) {
+			for (auto i = old_occupied.find_next(begin); i < end; i = old_occupied.find_next(i + 1)) {
+				auto& bucket = old_buckets[i];
+				while (!bucket.empty()) {
+					auto* node = bucket.release_front();
+					if (parts == 1) {
+						push_node(bucket_index(node_hash(node)), node);
+						continue;
+					}
+					auto& head = staged[part * stripes + bucket_index(node_hash(node)) / stripe];
+					node->next = head;
+					head = node;
+				}
+			}
+		};
+		if (parts == 1) {
+			unlink(0, 0, old_buckets.size());
+			return;
+		}
+		run_parts_nothrow(parts, old_buckets.size(), unlink);
+		run_parts_nothrow(parts, stripes, [&](std::size_t /*part*/, std::size_t begin, std::size_t end) {
+			for (auto s = begin; s < end; ++s) {
+				for (std::size_t part = 0; part < parts; ++part) {
+					for (auto* node = staged[part * stripes + s]; node;) {
+						auto* next = node->next;
+						auto index = bucket_index(node_hash(node));
+						buckets[index].push_front(node);
+						occupied.set(index);
+						node = next;
+					}
+				}
+			}
+		});
+		first_occupied = occupied.find_next(0);
+	}
+};
+} // namespace detail
+} // namespace tech
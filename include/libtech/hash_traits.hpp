@@ -0,0 +1,46 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace tech {
+// хранить ли полный хеш в ноде: rehash тогда только перевешивает указатели,
+// а при поиске ключи сравниваются только при совпадении хешей.
+// Для чисел, enum и указателей хеш дешевле лишних 8 байт на ноду
+template <class Key, class Hash>
+struct cache_hash_code : std::bool_constant<!(std::is_arithmetic_v<Key> || std::is_enum_v<Key> || std::is_pointer_v<Key>)> {};
+template <class Key, class Hash> inline constexpr bool cache_hash_code_v = cache_hash_code<Key, Hash>::value;
+
+// поиск по ключу другого типа (std::string_view для std::string и т.п.) без временного Key,
+// как в C++20: и хеш, и сравнение должны объявить is_transparent
+template <class Hash, class KeyEqual>
+concept transparent_lookup = requires {
+	typename Hash::is_transparent;
+	typename KeyEqual::is_transparent;
+};
+
+// хеш уже хорошо перемешан (каждый бит входа влияет на все биты выхода),
+// таблица берет его как есть. Иначе результат хеша перемешивается еще раз
+template <class Hash> struct is_avalanching : std::bool_constant<requires { typename Hash::is_avalanching; }> {};
+template <class Hash> inline constexpr bool is_avalanching_v = is_avalanching<Hash>::value;
+
+namespace detail {
+// достает ключ из аргументов emplace, не строя пару: (key, value), pair и
+// piecewise_construct с одним аргументом ключа. Остальное сначала конструируется
+template <class Key, class... Args> struct key_extractor : std::false_type {};
+template <class Key, class K, class V> struct key_extractor<Key, K, V> : std::is_same<K, Key> {
+	static const Key& get(const K& key, const V& /*value*/) { return key; }
+};
+template <class Key, class A, class B> struct key_extractor<Key, std::pair<A, B>> : std::is_same<std::remove_cv_t<A>, Key> {
+	static const Key& get(const std::pair<A, B>& value) { return value.first; }
+};
+template <class Key, class A, class V>
+struct key_extractor<Key, std::piecewise_construct_t, std::tuple<A>, V> : std::is_same<std::remove_cvref_t<A>, Key> {
+	static const Key& get(std::piecewise_construct_t /*tag*/, const std::tuple<A>& key, const V& /*value*/) {
+		return std::get<0>(key);
+	}
+};
+template <class Key, class... Args> using key_extractor_for = key_extractor<Key, std::remove_cvref_t<Args>...>;
+} // namespace detail
+} // namespace tech
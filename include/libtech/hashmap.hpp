@@ -1,240 +1,411 @@
 #pragma once
 
+#include <array>
 #include <cmath>
 #include <functional>
-#include <libtech/list.hpp>
-#include <libtech/vector.hpp>
+#include <iterator>
+#include <libtech/execution.hpp>
+#include <libtech/growth_policy.hpp>
+#include <libtech/hash.hpp>
+#include <libtech/hash_table.hpp>
+#include <libtech/hash_traits.hpp>
+#include <libtech/serialization.hpp>
+#include <libtech/stats_policy.hpp>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <iostream>
 
 namespace tech {
-template <class Key, class T, class Hash = std::hash<Key>, class Allocator = std::allocator<std::pair<Key, T>>> class HashMap {
+namespace detail {
+inline void prefetch(const void* ptr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(ptr);
+#else
+	(void)ptr;
+#endif
+}
+} // namespace detail
+
+// карта на ChainedTable, том же движке, что у HashSet и HashMultiMap: ведра, битмап, обход,
+// rehash и статистика общие. Здесь только то, что есть у карты с уникальными ключами:
+// node handle, merge, try_emplace, пакетные вставка и поиск, сериализация
+template <class Key, class T, class Hash = tech::Hash<Key>, class KeyEqual = std::equal_to<Key>, class Allocator = std::allocator<std::pair<Key, T>>, class GrowthPolicy = PrimeGrowthPolicy<>, class StatsPolicy = NoStatsPolicy>
+class HashMap : private detail::ChainedTable<std::pair<Key, T>, detail::MapKey, Key, Hash, KeyEqual, Allocator, GrowthPolicy, true, StatsPolicy> {
+	using table = detail::ChainedTable<std::pair<Key, T>, detail::MapKey, Key, Hash, KeyEqual, Allocator, GrowthPolicy, true, StatsPolicy>;
+
   public:
-	using size_type = std::size_t;
-	using value_type = std::pair<Key, T>;
-	using key_type = Key;
+	using typename table::size_type;
+	using typename table::value_type;
+	using typename table::key_type;
 	using mapped_type = T;
-	using bucket_type = List<value_type, Allocator>;
-	using buckets_type = Vector<bucket_type>;
-	using node_type = typename bucket_type::node_type;
+	using typename table::hasher;
+	using typename table::key_equal;
+	using typename table::allocator_type;
+	using typename table::bucket_type;
+	using typename table::buckets_type;
+	using typename table::node_type;
+	using typename table::growth_policy;
+	using typename table::stats_policy_type;
+	using typename table::iterator;
+	using typename table::const_iterator;
+	using typename table::bucket_range_type;
+	using typename table::const_bucket_range_type;
 
   private:
-	static constexpr const std::size_t INIT_BUCKET_COUNT = 1;
-	static constexpr const float DEFAULT_MAX_LOAD_FACTOR = 1;
-	buckets_type buckets;
-	Hash hash;
-	size_type items_count;
-	float max_saturation = DEFAULT_MAX_LOAD_FACTOR;
+	using typename table::node_allocator;
+	using table::node_alloc;
+	using table::buckets;
+	using table::occupied;
+	using table::first_occupied;
+	using table::hash;
+	using table::equal;
+	using table::items_count;
+	using table::max_saturation;
+	using table::stats_policy;
+	using table::hash_of;
+	using table::foreign_hash;
+	using table::lookup;
+	using table::new_node;
+	using table::push_node;
+	using table::insert_node;
+	using table::insert_new_node;
+	using table::unlink_node;
+	using table::unlink_at;
+	using table::bucket_emptied;
 
   public:
-	template <class ValueType, class HashMapType> class Iterator {
-	  public:
-		using difference_type = std::ptrdiff_t;
-		using value_type = ValueType;
-		using pointer = ValueType*;
-		using reference = ValueType&;
-		using iterator_category = std::forward_iterator_tag;
-		friend class HashMap;
-		//friend Iterator<ValueType, HashMapType> HashMap::erase(Iterator<ValueType, HashMapType>);
-	  private:
-		HashMapType* map;
-		ValueType* current;
-		decltype(map->buckets.end()) bucket_iterator;
-		decltype(bucket_iterator->begin()) list_iterator;
+	// владеющая ссылка на вынутую из карты ноду, как node handle из C++17.
+	// Ключ и значение не двигаются: extract и insert только перецепляют указатели
+	class node_handle {
 	  public:
-		Iterator(HashMapType* ptr)
-			: map(ptr), current(nullptr), bucket_iterator(nullptr),
-			  list_iterator(nullptr) {
-			if (map == nullptr) {
-				current = nullptr;
-				return;
-			}
-			bucket_iterator = map->buckets.begin();
-			while (bucket_iterator != map->buckets.end()) {
-				list_iterator = bucket_iterator->begin();
-				if (list_iterator != bucket_iterator->end()) {
-					current = &(*list_iterator);
-					return;
-				}
-				++bucket_iterator;
-			}
-			current = nullptr;
-		}
-		Iterator(HashMapType* ptr, bucket_type* bucket, node_type* node) : map(ptr), bucket_iterator(bucket), list_iterator(node) {
-			current = &(*list_iterator);
-		}
-		reference operator*() { return *current; }
-		pointer operator->() { return current; }
-		bool operator==(const Iterator& another) const {
-			return current == another.current;
-		}
-		Iterator& operator++() {
-			if (current) { // если у нас до этого что то было
-				if (++list_iterator == bucket_iterator->end()) {
-					// если это последний в ведре, меняем ведро
-					while (++bucket_iterator != map->buckets.end()) {
-						list_iterator = bucket_iterator->begin();
-						if (list_iterator != bucket_iterator->end()) {
-							break;
-						}
-					}
-					if (bucket_iterator == map->buckets.end()) {
-						// если это последнее ведро, то все
-						current = nullptr;
-						return *this;
-					}
-					if (list_iterator == bucket_iterator->end()) {
-						current = nullptr;
-						return *this;
-					}
-				}
-				current = &(*list_iterator);
+		using key_type = Key;
+		using mapped_type = T;
+		using allocator_type = Allocator;
+
+		node_handle() = default;
+		node_handle(const node_handle&) = delete;
+		node_handle(node_handle&& other) noexcept
+			: node(std::exchange(other.node, nullptr)), alloc(std::move(other.alloc)) {}
+		node_handle& operator=(const node_handle&) = delete;
+		node_handle& operator=(node_handle&& other) noexcept {
+			if (this != &other) {
+				reset();
+				node = std::exchange(other.node, nullptr);
+				alloc = std::move(other.alloc);
 			}
 			return *this;
 		}
-		Iterator operator++(int) {
-			auto old = *this;
-			++(*this);
-			return old;
+		~node_handle() { reset(); }
+
+		bool empty() const noexcept { return node == nullptr; }
+		explicit operator bool() const noexcept { return node != nullptr; }
+		// value_type хранит неконстантный Key, так что ключ можно поменять до вставки
+		Key& key() const { return node->value.first; }
+		T& mapped() const { return node->value.second; }
+		allocator_type get_allocator() const { return allocator_type(*alloc); }
+
+	  private:
+		friend class HashMap;
+		node_handle(node_type* _node, const node_allocator& _alloc) : node(_node), alloc(_alloc) {}
+		node_type* release() noexcept { return std::exchange(node, nullptr); }
+		void reset() noexcept {
+			if (node) {
+				bucket_type::destroy_node(*alloc, node);
+				node = nullptr;
+			}
 		}
+		node_type* node = nullptr;
+		// пустой handle аллокатора не держит
+		std::optional<node_allocator> alloc;
+	};
+	struct insert_return_type {
+		iterator position;
+		bool inserted;
+		node_handle node;
 	};
-	using iterator = Iterator<value_type, HashMap>;
-	using const_iterator = Iterator<const value_type, const HashMap>;
 
+  private:
+	// для erase и try_emplace K не должен путаться с итератором
+	template<class K>
+	static constexpr bool transparent_key = transparent_lookup<Hash, KeyEqual> &&
+		!std::is_convertible_v<K, iterator> && !std::is_convertible_v<K, const_iterator>;
+
+  public:
 	/* constructors */
-	HashMap() : buckets(1), hash({}), items_count(0) {
-		buckets.reserve(1);
-		buckets.resize(1);
-	}
+	HashMap() : HashMap(Allocator()) {}
+	explicit HashMap(const Allocator& alloc) : table(1, Hash(), KeyEqual(), alloc) {}
 	template<class InputIt>
-	HashMap(InputIt first, InputIt last, size_type buckets_count = 1, const Hash& _hash = Hash()) : buckets(buckets_count), hash(_hash), items_count(0) {
-		buckets.resize(std::distance(first, last));
-		insert(first, last);
-	}
-	HashMap(std::initializer_list<value_type> init, size_type buckets_count = 1, const Hash& _hash = Hash()) : HashMap(init.begin(), init.end(), buckets_count, _hash) {}
-	explicit HashMap(size_type buckets_count, const Hash& _hash = Hash())
-		: buckets(buckets_count), hash(_hash), items_count(0) {
-		buckets.resize(buckets_count);
+	HashMap(InputIt first, InputIt last, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: table(buckets_count, _hash, _equal, alloc) {
+		bulk_insert(first, last);
 	}
+	HashMap(std::initializer_list<value_type> init, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: HashMap(init.begin(), init.end(), buckets_count, _hash, _equal, alloc) {}
+	explicit HashMap(size_type buckets_count, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: table(buckets_count, _hash, _equal, alloc) {}
 
-	/* rule of 5 */
-	HashMap(const HashMap& other)
-		: buckets(other.buckets), hash(other.hash_function()),
-		  items_count(other.size()) {}
-	HashMap(HashMap&& other) noexcept
-		: buckets(std::move(other.buckets)),
-		  hash(std::move(other.hash_function())), items_count(other.size()) {
-		other.items_count = 0;
-	}
-	HashMap& operator=(const HashMap& other) {
-		buckets = other.buckets;
-		hash = other.hash_function();
-		items_count = other.size();
-	}
-	HashMap& operator=(HashMap&& other) {
-		buckets = std::move(other.buckets);
-		hash = std::move(other.hash_function());
-		items_count = other.size();
-		other.items_count = 0;
-	}
+	using table::get_allocator;
 
 	/* iterators */
-	iterator begin() noexcept {
-		return iterator(this);
-	}
-	iterator end() noexcept {
-		return iterator(static_cast<HashMap*>(nullptr));
-	}
-	const_iterator begin() const noexcept {
-		return const_iterator(this);
-	}
-	const_iterator end() const noexcept {
-		return const_iterator(static_cast<const HashMap*>(nullptr));
-	}
-	const_iterator cbegin() const noexcept {
-		return const_iterator(this);
-	}
-	const_iterator cend() const noexcept {
-		return const_iterator(static_cast<const HashMap*>(nullptr));
-	}
+	using table::begin;
+	using table::end;
+	using table::cbegin;
+	using table::cend;
 
 	/* capacity */
-	size_type size() const noexcept { return items_count; }
-	bool empty() const noexcept { return size() == 0; }
+	using table::size;
+	using table::empty;
 
 	/* modifiers */
-	void clear() noexcept {
-		buckets.clear();
-		items_count = 0;
-	}
+	using table::clear;
 	std::pair<iterator, bool> insert(const value_type& value) {
 		return emplace(value);
 	}
 	std::pair<iterator, bool> insert(value_type&& value) {
 		return emplace(std::forward<value_type>(value));
 	}
+	// нода другой карты: аллокаторы должны быть равны, как и в std.
+	// Если ключ уже есть, нода возвращается обратно в insert_return_type::node
+	insert_return_type insert(node_handle&& handle) {
+		if (handle.empty()) {
+			return {end(), false, node_handle()};
+		}
+		auto* node = handle.node;
+		// закешированный хеш не годится: ключ могли поменять через key(), а хешер другой карты может отличаться
+		std::size_t h = hash_of(node->value.first);
+		if (auto* finded = lookup(node->value.first, h)) {
+			return {iterator(this, &buckets[bucket_index(h)], finded), false, std::move(handle)};
+		}
+		// если rehash бросит, нода еще принадлежит handle
+		auto pos = insert_node(node, h);
+		handle.release();
+		return {pos, true, node_handle()};
+	}
+	iterator insert(const_iterator /*hint*/, node_handle&& handle) {
+		return insert(std::move(handle)).position;
+	}
 	template<class InputIt>
 	void insert(InputIt first, InputIt last) {
-		for (auto it = first; it != last; ++it) {
-			insert(*it);
+		bulk_insert(first, last);
+	}
+	// вставка диапазона: один reserve, хеши отдельным проходом, потом раскладка по ведрам.
+	// Из повторяющихся ключей остается первый. Возвращает число вставленных
+	template<class InputIt>
+	size_type bulk_insert(InputIt first, InputIt last) {
+		return bulk_insert(execution::seq, first, last);
+	}
+	// с execution::par хеши считаются параллельно, а для std::allocator и
+	// произвольного доступа к диапазону ноды раскладываются по полосам ведер в нескольких потоках
+	template<class ExecutionPolicy, class InputIt> requires execution::is_execution_policy_v<ExecutionPolicy>
+	size_type bulk_insert(ExecutionPolicy&& exec, InputIt first, InputIt last) {
+		if constexpr (!std::forward_iterator<InputIt>) {
+			// однопроходный диапазон заранее не посчитать
+			size_type inserted = 0;
+			for (; first != last; ++first) {
+				inserted += emplace(*first).second ? 1 : 0;
+			}
+			return inserted;
+		} else {
+			auto count = static_cast<size_type>(std::distance(first, last));
+			if (count == 0) {
+				return 0;
+			}
+			rehash(exec, std::ceil((size() + count) / max_load_factor()));
+			auto parts = detail::parts_for(exec, count);
+			// временный массив не из аллокатора карты: арена держала бы его до своего release()
+			std::vector<std::size_t> hashes(count);
+			stats_policy.on_allocate(count * sizeof(std::size_t));
+			detail::run_parts(parts, count, [&](std::size_t /*part*/, std::size_t begin, std::size_t end) {
+				auto it = std::next(first, static_cast<std::ptrdiff_t>(begin));
+				for (auto i = begin; i < end; ++i, ++it) {
+					hashes[i] = hash_of((*it).first);
+				}
+			});
+			if constexpr (is_concurrent_allocator<Allocator>::value && std::random_access_iterator<InputIt>) {
+				if (parts > 1) {
+					return scatter_parallel(parts, first, hashes);
+				}
+			}
+			size_type inserted = 0;
+			for (size_type i = 0; i < count; ++i, ++first) {
+				auto index = bucket_index(hashes[i]);
+				if (insert_prehashed(index, *first, hashes[i])) {
+					first_occupied = std::min(first_occupied, index);
+					++items_count;
+					++inserted;
+				}
+			}
+			return inserted;
 		}
 	}
-	iterator erase(iterator pos) {
-		if (pos == end()) {
-			return end();
+	template<class ExecutionPolicy, class InputIt> requires execution::is_execution_policy_v<ExecutionPolicy>
+	static HashMap build_from(ExecutionPolicy&& exec, InputIt first, InputIt last, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator()) {
+		HashMap map(buckets_count, _hash, _equal, alloc);
+		map.bulk_insert(std::forward<ExecutionPolicy>(exec), first, last);
+		return map;
+	}
+	/* serialization */
+	// двоичный снимок: число ведер, затем элементы блоками. Ключи и значения пишет tech::serializer
+	void save(BinaryWriter& writer) const {
+		writer.write_value(detail::SerializedHeader::make(bucket_count(), size()));
+		auto it = begin();
+		for (std::uint64_t left = size(); left != 0;) {
+			auto block = std::min(left, detail::SERIALIZED_BLOCK_ITEMS);
+			writer.write_value(block);
+			for (std::uint64_t i = 0; i < block; ++i, ++it) {
+				serializer<Key>::write(writer, it->first);
+				serializer<T>::write(writer, it->second);
+			}
+			left -= block;
 		}
-		auto old = pos++;
-		auto bucket_it = old.bucket_iterator;
-		auto list_it = old.list_iterator;
-		bucket_it->erase(list_it);
-		--items_count;
-		return pos;
-		//return iterator(this, &(*bucket_it), ((bucket_it->erase(list_it)).current));
+		writer.write_value(std::uint64_t(0));
+	}
+	void save(std::ostream& out) const {
+		BinaryWriter writer(out);
+		save(writer);
+		writer.flush();
+	}
+	// таблица выделяется один раз, ключи считаются уникальными (их писал save) и вставляются
+	// без поиска дубликатов. При ошибке карта не меняется
+	void load(BinaryReader& reader) {
+		auto header = reader.read_value<detail::SerializedHeader>();
+		header.check();
+		HashMap loaded(std::max<size_type>(header.bucket_count, std::ceil(header.size / max_load_factor())), hash, equal, get_allocator());
+		loaded.max_saturation = max_saturation;
+		// ноды блока сначала создаются и хешируются с запросом ведра в кеш, потом цепляются:
+		// к моменту вставки ведра уже подгружены
+		std::array<std::pair<node_type*, size_type>, LOAD_BATCH> batch;
+		while (auto block = reader.read_value<std::uint64_t>()) {
+			while (block != 0) {
+				auto count = static_cast<size_type>(std::min<std::uint64_t>(block, LOAD_BATCH));
+				size_type created = 0;
+				try {
+					for (; created < count; ++created) {
+						auto key = serializer<Key>::read(reader);
+						auto value = serializer<T>::read(reader);
+						auto* node = loaded.new_node(std::move(key), std::move(value));
+						std::size_t h = loaded.hash_of(node->value.first);
+						node->hash_code.set(h);
+						batch[created] = {node, loaded.bucket_index(h)};
+						detail::prefetch(&loaded.buckets[batch[created].second]);
+					}
+				} catch (...) {
+					// еще не прицепленные ноды карте не принадлежат
+					for (size_type i = 0; i < created; ++i) {
+						bucket_type::destroy_node(loaded.node_alloc, batch[i].first);
+					}
+					throw;
+				}
+				for (size_type i = 0; i < count; ++i) {
+					loaded.push_node(batch[i].second, batch[i].first);
+				}
+				loaded.items_count += count;
+				block -= count;
+			}
+		}
+		if (loaded.size() != header.size) {
+			throw std::runtime_error("HashMap::load: item count does not match header\n");
+		}
+		*this = std::move(loaded);
+		stats_policy.add(loaded.stats_policy);
+	}
+	// поток остается сразу за данными карты
+	void load(std::istream& in) {
+		BinaryReader reader(in);
+		load(reader);
+		reader.rewind_unread();
+	}
+
+	iterator erase(iterator pos) {
+		return table::erase(pos);
 	}
 
 	template<class... Args>
 	std::pair<iterator, bool> emplace(Args&&... args) {
-		// создать элемент, проверить есть ли с таким ключом, если есть уничтожить созданный, если нет увеличить? вектор, вставить элемент
-		auto* node = std::allocator<node_type>().allocate(1);
-		std::construct_at(node, std::forward<Args>(args)...);
-		// auto* node = new typename bucket_type::node_type(std::forward<Args>(args)...);
-		auto finded = find(node->value->first);
-		if (finded != end()) {
-			// delete node;
-			std::destroy_at(node);
-			std::allocator<node_type>().deallocate(node, 1);
-			return {finded, false};
-		}
-		if ((size() + 1) > (max_load_factor() * bucket_count())) {
-			rehash(bucket_count() + 1); // проработать стратегию расширения
-		}
-		std::size_t h = hash(node->value->first);
-		std::size_t pos = bucket_index(h);
-		auto& bucket = buckets[pos];
-		bucket.push_back(node);
-		++items_count;
-		iterator it(this, &bucket, node);
-		return {it, true};
+		// если ключ виден в аргументах, нода выделяется только когда ключа нет
+		return table::emplace_unique(std::forward<Args>(args)...);
+	}
+	// в ведрах порядка нет, подсказка ничего не дает
+	template<class... Args>
+	iterator emplace_hint(const_iterator /*hint*/, Args&&... args) {
+		return emplace(std::forward<Args>(args)...).first;
 	}
 	template<class... Args>
 	std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
-		auto finded = find(key);
-		if (finded != end()) {
-			return {finded, false};
-		}
-		return emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		return try_emplace_impl(key, std::forward<Args>(args)...);
 	}
 	template<class... Args>
 	std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
-		auto finded = find(key);
-		if (finded != end()) {
-			return {finded, false};
+		return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+	}
+	template<class K, class... Args> requires transparent_key<K>
+	std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+		// Key строится из K только если такого ключа еще нет
+		return try_emplace_impl(std::forward<K>(key), std::forward<Args>(args)...);
+	}
+	template<class M>
+	std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj) {
+		return insert_or_assign_impl(key, std::forward<M>(obj));
+	}
+	template<class M>
+	std::pair<iterator, bool> insert_or_assign(Key&& key, M&& obj) {
+		return insert_or_assign_impl(std::move(key), std::forward<M>(obj));
+	}
+	template<class K, class M> requires transparent_key<K>
+	std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj) {
+		return insert_or_assign_impl(std::forward<K>(key), std::forward<M>(obj));
+	}
+	size_type erase(const Key& key) {
+		return table::erase_key(key);
+	}
+	node_handle extract(const_iterator pos) {
+		return node_handle(unlink_at(pos), node_alloc);
+	}
+	node_handle extract(iterator pos) {
+		return node_handle(unlink_at(pos), node_alloc);
+	}
+	node_handle extract(const Key& key) {
+		return extract_impl(key);
+	}
+	template<class K> requires transparent_key<K>
+	node_handle extract(K&& key) {
+		return extract_impl(key);
+	}
+	// ноды source с ключами, которых здесь нет, перецепляются сюда, остальные остаются в source.
+	// Аллокаторы карт должны быть равны
+	void merge(HashMap& source) {
+		if (&source == this) {
+			return;
+		}
+		// ведра заранее: insert_node ниже не делает rehash и не бросает
+		if (size() + source.size() > max_load_factor() * bucket_count()) {
+			reserve(size() + source.size());
+		}
+		for (auto i = source.first_occupied; i < source.bucket_count(); i = source.occupied.find_next(i + 1)) {
+			auto& from = source.buckets[i];
+			for (auto it = from.begin(); it != from.end();) {
+				auto* node = (it++).current;
+				std::size_t h = foreign_hash(node);
+				if (find_node(buckets[bucket_index(h)], node->value.first, h)) {
+					continue;
+				}
+				source.unlink_node(i, node);
+				insert_node(node, h);
+			}
 		}
-		return emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
 	}
-
+	void merge(HashMap&& source) {
+		merge(source);
+	}
+	template<class K> requires transparent_key<K>
+	size_type erase(K&& key) {
+		return table::erase_key(key);
+	}
 
 	/* lookup */
 	T& operator[](const Key& key) {
@@ -243,116 +414,253 @@ template <class Key, class T, class Hash = std::hash<Key>, class Allocator = std
 	T& operator[](Key&& key) {
 		return try_emplace(std::move(key)).first->second; // в cppreference используется std::move а не std::forward
 	}
+	template<class K> requires transparent_key<K>
+	T& operator[](K&& key) {
+		return try_emplace(std::forward<K>(key)).first->second;
+	}
 	T& at(const Key& key) {
-		std::size_t h = hash(key);
-		std::size_t pos = bucket_index(h);
-		auto& bucket = buckets[pos];
-		auto* finded = find_value(bucket, key);
-		if (!finded) {
-			throw std::out_of_range("No value with key\n");
-		}
-		return finded->second;
+		return at_impl(key);
 	}
 	const T& at(const Key& key) const {
-		std::size_t h = hash(key);
-		std::size_t pos = bucket_index(h);
-		auto& bucket = buckets[pos];
-		auto* finded = find_value(bucket, key);
-		if (!finded) {
-			throw std::out_of_range("No value with key\n");
-		}
-		return finded->second;
+		return at_impl(key);
+	}
+	template<class K> requires transparent_lookup<Hash, KeyEqual>
+	T& at(const K& key) {
+		return at_impl(key);
+	}
+	template<class K> requires transparent_lookup<Hash, KeyEqual>
+	const T& at(const K& key) const {
+		return at_impl(key);
 	}
 	size_type count(const Key& key) const {
-		return buckets[bucket_index(hash(key))].size();
+		return table::count(key);
+	}
+	template<class K> requires transparent_lookup<Hash, KeyEqual>
+	size_type count(const K& key) const {
+		return table::count(key);
 	}
 	iterator find(const Key& key) {
-		for (auto it = begin(); it != end(); ++it) { // итерируемся по мапе
-			if (it->first == key) { // если нашли нужную пару
-				return it;
-			}
-		}
-		return end();
+		return table::find(key);
 	}
 	const_iterator find(const Key& key) const {
-		for (auto it = begin(); it != end(); ++it) { // итерируемся по мапе
-			if (it->first == key) { // если нашли нужную пару
-				return it;
-			}
-		}
-		return end();
+		return table::find(key);
+	}
+	template<class K> requires transparent_lookup<Hash, KeyEqual>
+	iterator find(const K& key) {
+		return table::find(key);
+	}
+	template<class K> requires transparent_lookup<Hash, KeyEqual>
+	const_iterator find(const K& key) const {
+		return table::find(key);
 	}
 	bool contains(const Key& key) const {
-		return find(key) != end();
+		return table::contains(key);
+	}
+	template<class K> requires transparent_lookup<Hash, KeyEqual>
+	bool contains(const K& key) const {
+		return table::contains(key);
+	}
+	// пакетный поиск: results[i] для keys[i], промах - end(). results короче keys - std::length_error
+	void find_many(std::span<const Key> keys, std::span<iterator> results) {
+		probe_many(keys, results.size(), [&](size_type i, size_type index, node_type* node) {
+			results[i] = node ? iterator(this, &buckets[index], node) : end();
+		});
+	}
+	void find_many(std::span<const Key> keys, std::span<const_iterator> results) const {
+		probe_many(keys, results.size(), [&](size_type i, size_type index, node_type* node) {
+			results[i] = node ? const_iterator(this, &buckets[index], node) : end();
+		});
+	}
+	// указатель на значение, промах - nullptr
+	void find_many(std::span<const Key> keys, std::span<T*> results) {
+		probe_many(keys, results.size(), [&](size_type i, size_type /*index*/, node_type* node) {
+			results[i] = node ? &node->value.second : nullptr;
+		});
+	}
+	// возвращает число найденных
+	size_type contains_many(std::span<const Key> keys, std::span<bool> results) const {
+		size_type found = 0;
+		probe_many(keys, results.size(), [&](size_type i, size_type /*index*/, node_type* node) {
+			results[i] = node != nullptr;
+			found += node ? 1 : 0;
+		});
+		return found;
 	}
 
 	/* bucket interface */
-	size_type bucket_count() const { return buckets.size(); }
-	size_type bucket_size(size_type n) const { return buckets[n].size(); }
+	using table::bucket_count;
+	using table::bucket_size;
+	using table::bucket_range;
 
 	/* hash policy */
-	float load_factor() const { return size() / bucket_count(); }
-	void rehash(size_type count) {
-		// надо изменить количество ведер и перенести
-		// указатели на Node без создания новых объектов,
-		// просто работа с указателями
-		if (count == buckets.size()) {
-			return;
+	using table::load_factor;
+	using table::rehash;
+	using table::reserve;
+	using table::max_load_factor;
+	using table::find_node;
+	value_type* find_value(const bucket_type& bucket, const Key& key, std::size_t h) const {
+		auto* node = find_node(bucket, key, h);
+		return node ? &node->value : nullptr;
+	}
+	value_type* find_value(const bucket_type& bucket, const Key& key) const {
+		return find_value(bucket, key, hash_of(key));
+	}
+
+	/* observers */
+	using table::hash_function;
+	using table::key_eq;
+
+	/* statistics */
+	using table::stats;
+	using table::dump_stats;
+
+	using table::bucket_index;
+
+  private:
+	template<class K>
+	T& at_impl(const K& key) const {
+		std::size_t h = hash_of(key);
+		auto* node = lookup(key, h);
+		if (!node) {
+			throw std::out_of_range("No value with key\n");
+		}
+		return node->value.second;
+	}
+	template<class K, class... Args>
+	std::pair<iterator, bool> try_emplace_impl(K&& key, Args&&... args) {
+		std::size_t h = hash_of(key);
+		if (auto* finded = lookup(key, h)) {
+			return {iterator(this, &buckets[bucket_index(h)], finded), false};
+		}
+		auto* node = new_node(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		return {insert_new_node(node, h), true};
+	}
+	template<class K, class M>
+	std::pair<iterator, bool> insert_or_assign_impl(K&& key, M&& obj) {
+		auto result = try_emplace_impl(std::forward<K>(key), std::forward<M>(obj));
+		if (!result.second) {
+			result.first->second = std::forward<M>(obj);
 		}
-		if (count * max_load_factor() < size()) {
-			count = size() / max_load_factor();
+		return result;
+	}
+	static constexpr const size_type LOAD_BATCH = 64;
+	template<class K>
+	node_handle extract_impl(const K& key) {
+		std::size_t h = hash_of(key);
+		auto* node = lookup(key, h);
+		if (!node) {
+			return node_handle();
+		}
+		unlink_node(bucket_index(h), node);
+		return node_handle(node, node_alloc);
+	}
+	// конвейер по ключам: ключ i хешируется и его ведро запрашивается в кеш,
+	// для ключа i - D запрашивается первая нода, ключ i - 2D сравнивается.
+	// Пока идет сравнение, память для следующих ключей уже подгружается
+	static constexpr const size_type PROBE_DISTANCE = 8;
+	static constexpr const size_type PROBE_RING = 32; // степень двойки не меньше 2 * PROBE_DISTANCE + 1
+	template<class F>
+	void probe_many(std::span<const Key> keys, size_type results_count, F&& on_result) const {
+		if (results_count < keys.size()) {
+			throw std::length_error("HashMap::find_many: results shorter than keys\n");
 		}
-		if (count == buckets.capacity()) {
+		std::array<std::size_t, PROBE_RING> hashes;
+		std::array<size_type, PROBE_RING> indices;
+		const auto count = keys.size();
+		if (bucket_count() == 0) {
+			for (size_type i = 0; i < count; ++i) {
+				stats_policy.on_lookup(false);
+				on_result(i, 0, nullptr);
+			}
 			return;
 		}
-		//auto old_buckets = std::move(buckets);
-		buckets_type new_buckets;
-		
-		new_buckets.reserve(count);
-		new_buckets.resize(count);
-
-		node_type* node = nullptr;
-		// нужно проитерировать по нодам
-		for (auto bucket_it = buckets.begin();
-			 bucket_it != buckets.end(); ++bucket_it) {
-			for (auto list_it = bucket_it->begin();
-				 list_it != bucket_it->end();
-				 ++list_it) {
-				if (node) {
-					auto h = hash(node->value->first);
-					new_buckets[h % new_buckets.capacity()].push_back(node);
+		for (size_type i = 0; i < count + 2 * PROBE_DISTANCE; ++i) {
+			if (i < count) {
+				auto slot = i % PROBE_RING;
+				hashes[slot] = hash_of(keys[i]);
+				indices[slot] = bucket_index(hashes[slot]);
+				detail::prefetch(&buckets[indices[slot]]);
+			}
+			if (i >= PROBE_DISTANCE && i - PROBE_DISTANCE < count) {
+				if (auto* first = buckets[indices[(i - PROBE_DISTANCE) % PROBE_RING]].begin().current) {
+					detail::prefetch(first);
 				}
-				node = bucket_it->erase(list_it, true);
-
-				// возможна проблема из-за push_back указатели будут меняться а
-				// значит и итератор может сломаться, решение: сделать задержку
+			}
+			if (i >= 2 * PROBE_DISTANCE) {
+				auto j = i - 2 * PROBE_DISTANCE;
+				auto slot = j % PROBE_RING;
+				auto* node = find_node(buckets[indices[slot]], keys[j], hashes[slot]);
+				on_result(j, indices[slot], node);
 			}
 		}
-		auto h = hash(node->value->first);
-		new_buckets[h % new_buckets.capacity()].push_back(node);
-		// не забыть про последнюю ноду из за задержки
-		buckets = std::move(new_buckets);
-	}
-	void reserve(size_type count) {
-		rehash(std::ceil(count / max_load_factor()));
-	}
-	void max_load_factor(float lf) {
-		max_saturation = lf;
-		if (load_factor() > max_saturation) {
-			reserve(size());
+	}
+	// таблица уже нужного размера, хеш посчитан; first_occupied и items_count на вызывающем
+	template<class V>
+	bool insert_prehashed(size_type index, V&& value, std::size_t h) {
+		if (find_node(buckets[index], value.first, h) != nullptr) {
+			return false;
+		}
+		auto* node = new_node(std::forward<V>(value));
+		node->hash_code.set(h);
+		buckets[index].push_front(node);
+		occupied.set(index);
+		return true;
+	}
+	// элементы раскладываются по полосам ведер (полоса кратна 64 ведрам, чтобы
+	// потоки не делили слова битмапа), затем каждая полоса заполняется своим потоком.
+	// Внутри полосы порядок входа сохраняется, так что из дубликатов остается первый
+	template<class RandomIt>
+	size_type scatter_parallel(std::size_t parts, RandomIt first, const std::vector<std::size_t>& hashes) {
+		const auto count = hashes.size();
+		const size_type word = detail::BucketBitmap<Allocator>::WORD_BITS;
+		const size_type stripe = std::max<size_type>((bucket_count() / parts + word - 1) / word * word, word);
+		const size_type stripes = (bucket_count() + stripe - 1) / stripe;
+		std::vector<size_type> offsets(parts * stripes, 0);
+		detail::run_parts(parts, count, [&](std::size_t part, std::size_t begin, std::size_t end) {
+			for (auto i = begin; i < end; ++i) {
+				++offsets[part * stripes + bucket_index(hashes[i]) / stripe];
+			}
+		});
+		size_type total = 0;
+		for (size_type s = 0; s < stripes; ++s) {
+			for (std::size_t part = 0; part < parts; ++part) {
+				total += std::exchange(offsets[part * stripes + s], total);
+			}
 		}
-	} // если lf < 0 то что?
-	float max_load_factor() const { return max_saturation; }
-	value_type* find_value(bucket_type& bucket, const Key& key) {
-		// std::cout << "find_node(bucket, " << key << ")\n";
-		for (auto& pair : bucket) {
-			// std::cout << "pair.first == " << pair.first << '\n';
-			if (pair.first == key) {
-				return &pair;
+		std::vector<size_type> order(count);
+		detail::run_parts(parts, count, [&](std::size_t part, std::size_t begin, std::size_t end) {
+			for (auto i = begin; i < end; ++i) {
+				order[offsets[part * stripes + bucket_index(hashes[i]) / stripe]++] = i;
+			}
+		});
+		// после раскладки offsets[(parts - 1) * stripes + s] указывает на конец полосы s
+		std::vector<size_type> inserted(stripes, 0);
+		auto fill_stripe = [&](std::size_t s, std::size_t /*begin*/, std::size_t /*end*/) {
+			auto from = s == 0 ? 0 : offsets[(parts - 1) * stripes + s - 1];
+			auto to = offsets[(parts - 1) * stripes + s];
+			for (auto k = from; k < to; ++k) {
+				auto i = order[k];
+				if (insert_prehashed(bucket_index(hashes[i]), first[static_cast<std::ptrdiff_t>(i)], hashes[i])) {
+					++inserted[s];
+				}
+			}
+		};
+		auto finish = [&] {
+			size_type result = 0;
+			for (auto n : inserted) {
+				result += n;
 			}
+			items_count += result;
+			first_occupied = occupied.find_next(0);
+			return result;
+		};
+		try {
+			detail::run_parts(stripes, stripes, fill_stripe);
+		} catch (...) {
+			finish();
+			throw;
 		}
-		return nullptr;
+		return finish();
 	}
-	std::size_t bucket_index(std::size_t h) { return h % buckets.capacity(); }
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,592 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <libtech/forward_list.hpp>
+#include <libtech/hash.hpp>
+#include <libtech/hash_traits.hpp>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace tech {
+// хеш-таблица на цепочках с постепенным rehash (как dict в Redis): при росте старая таблица
+// остается жить, и каждая вставка, удаление и неконстантный find переносят несколько ее ведер
+// в новую. Вставка, пересекшая порог заполнения, не останавливается на перенос всей таблицы.
+//
+// Таблица растет только вдвое, поэтому ведро i старой таблицы переходит в ведра i и i + n новой.
+// Ведро старой таблицы, которое еще не перенесено, продолжает принимать свои ключи, так что
+// каждый ключ ищется ровно в одном ведре, а новая таблица не обнуляется целиком при выделении
+template <class Key, class T, class Hash = tech::Hash<Key>, class KeyEqual = std::equal_to<Key>,
+		  class Allocator = std::allocator<std::pair<Key, T>>>
+class IncrementalHashMap {
+  public:
+	using size_type = std::size_t;
+	using value_type = std::pair<Key, T>;
+	using key_type = Key;
+	using mapped_type = T;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using allocator_type = Allocator;
+	using node_type = typename ForwardList<value_type, Allocator, cache_hash_code_v<Key, Hash>>::node_type;
+
+  private:
+	using list_type = ForwardList<value_type, Allocator, cache_hash_code_v<Key, Hash>>;
+	using node_allocator = typename list_type::node_allocator;
+	using node_traits = std::allocator_traits<node_allocator>;
+	using heads_allocator = typename node_traits::template rebind_alloc<node_type*>;
+	using heads_traits = std::allocator_traits<heads_allocator>;
+
+	// массив голов цепочек, размер - степень двойки
+	struct Table {
+		node_type** heads = nullptr;
+		size_type count = 0;
+		size_type mask() const { return count - 1; }
+	};
+
+	static constexpr const size_type INIT_BUCKET_COUNT = 8;
+	static constexpr const float DEFAULT_MAX_LOAD_FACTOR = 1;
+	// ведер старой таблицы на одну операцию: перенос заканчивается за n / MIGRATE_BUCKETS вставок,
+	// задолго до того, как новая таблица заполнится
+	static constexpr const size_type MIGRATE_BUCKETS = 4;
+
+	[[no_unique_address]] node_allocator node_alloc;
+	Table table;
+	// старая таблица, пока идет перенос. Ведра [0, migrated) уже перенесены
+	Table old_table;
+	size_type migrated = 0;
+	Hash hash;
+	[[no_unique_address]] KeyEqual equal;
+	size_type items_count = 0;
+	float max_saturation = DEFAULT_MAX_LOAD_FACTOR;
+
+  public:
+	template <class ValueType, class MapType> class Iterator {
+	  public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = ValueType;
+		using pointer = ValueType*;
+		using reference = ValueType&;
+		using iterator_category = std::forward_iterator_tag;
+		friend class IncrementalHashMap;
+
+	  private:
+		MapType* map = nullptr;
+		node_type* current = nullptr;
+
+	  public:
+		Iterator() = default;
+		Iterator(MapType* ptr, node_type* node) : map(ptr), current(node) {}
+		reference operator*() const { return current->value; }
+		pointer operator->() const { return &current->value; }
+		bool operator==(const Iterator& another) const { return current == another.current; }
+		Iterator& operator++() {
+			if (current->next) {
+				current = current->next;
+			} else {
+				// ведро ноды определяется по ее хешу, так что итератор переживает перенос ведер
+				current = map->node_after_bucket_of(current);
+			}
+			return *this;
+		}
+		Iterator operator++(int) {
+			auto old = *this;
+			++(*this);
+			return old;
+		}
+	};
+	using iterator = Iterator<value_type, IncrementalHashMap>;
+	using const_iterator = Iterator<const value_type, const IncrementalHashMap>;
+
+  private:
+	// для erase и try_emplace K не должен путаться с итератором
+	template <class K>
+	static constexpr bool transparent_key = transparent_lookup<Hash, KeyEqual> &&
+		!std::is_convertible_v<K, iterator> && !std::is_convertible_v<K, const_iterator>;
+
+  public:
+	/* constructors */
+	IncrementalHashMap() : IncrementalHashMap(Allocator()) {}
+	explicit IncrementalHashMap(const Allocator& allocator) : node_alloc(allocator), hash({}) {
+		table = make_table(INIT_BUCKET_COUNT);
+	}
+	explicit IncrementalHashMap(size_type buckets_count, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& allocator = Allocator())
+		: node_alloc(allocator), hash(_hash), equal(_equal) {
+		table = make_table(table_size_for(buckets_count));
+	}
+	template <class InputIt>
+	IncrementalHashMap(InputIt first, InputIt last, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& allocator = Allocator())
+		: IncrementalHashMap(buckets_count, _hash, _equal, allocator) {
+		insert(first, last);
+	}
+	IncrementalHashMap(std::initializer_list<value_type> init, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& allocator = Allocator())
+		: IncrementalHashMap(init.begin(), init.end(), buckets_count, _hash, _equal, allocator) {}
+
+	/* rule of 5 */
+	IncrementalHashMap(const IncrementalHashMap& other)
+		: node_alloc(node_traits::select_on_container_copy_construction(other.node_alloc)), hash(other.hash),
+		  equal(other.equal), max_saturation(other.max_saturation) {
+		table = make_table(table_size_for(other.bucket_count()));
+		copy_values(other);
+	}
+	IncrementalHashMap(IncrementalHashMap&& other) noexcept
+		: node_alloc(other.node_alloc), table(std::exchange(other.table, {})),
+		  old_table(std::exchange(other.old_table, {})), migrated(std::exchange(other.migrated, 0)),
+		  hash(std::move(other.hash)), equal(std::move(other.equal)),
+		  items_count(std::exchange(other.items_count, 0)), max_saturation(other.max_saturation) {}
+	IncrementalHashMap& operator=(const IncrementalHashMap& other) {
+		if (this == &other) {
+			return *this;
+		}
+		release();
+		if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+			node_alloc = other.node_alloc;
+		}
+		hash = other.hash;
+		equal = other.equal;
+		max_saturation = other.max_saturation;
+		table = make_table(table_size_for(other.bucket_count()));
+		copy_values(other);
+		return *this;
+	}
+	IncrementalHashMap& operator=(IncrementalHashMap&& other) {
+		if (this == &other) {
+			return *this;
+		}
+		release();
+		hash = std::move(other.hash);
+		equal = std::move(other.equal);
+		max_saturation = other.max_saturation;
+		if constexpr (!node_traits::propagate_on_container_move_assignment::value) {
+			if (node_alloc != other.node_alloc) {
+				// ноды чужого аллокатора забрать нельзя, переносим значения
+				table = make_table(table_size_for(other.bucket_count()));
+				for (auto& value : other) {
+					emplace(std::move(value));
+				}
+				other.clear();
+				return *this;
+			}
+		} else {
+			node_alloc = std::move(other.node_alloc);
+		}
+		table = std::exchange(other.table, {});
+		old_table = std::exchange(other.old_table, {});
+		migrated = std::exchange(other.migrated, 0);
+		items_count = std::exchange(other.items_count, 0);
+		return *this;
+	}
+	~IncrementalHashMap() { release(); }
+	allocator_type get_allocator() const noexcept { return allocator_type(node_alloc); }
+
+	/* iterators */
+	// пока идет перенос, сначала обходятся ведра старой таблицы, потом новой.
+	// Итераторы не инвалидируются переносом, но если между шагами обхода карта меняется
+	// (вставка, erase по ключу, неконстантный find), перенесенные ноды могут встретиться дважды.
+	// erase(iterator) ведра не переносит, так что цикл удаления по итераторам безопасен
+	iterator begin() noexcept { return iterator(this, first_node()); }
+	const_iterator begin() const noexcept { return const_iterator(this, first_node()); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	iterator end() noexcept { return iterator(this, nullptr); }
+	const_iterator end() const noexcept { return const_iterator(this, nullptr); }
+	const_iterator cend() const noexcept { return end(); }
+
+	/* capacity */
+	bool empty() const noexcept { return items_count == 0; }
+	size_type size() const noexcept { return items_count; }
+
+	/* modifiers */
+	void clear() noexcept {
+		destroy_nodes();
+		free_table(old_table);
+		migrated = 0;
+		std::fill_n(table.heads, table.count, nullptr);
+		items_count = 0;
+	}
+	std::pair<iterator, bool> insert(const value_type& value) { return emplace(value); }
+	std::pair<iterator, bool> insert(value_type&& value) { return emplace(std::move(value)); }
+	template <class InputIt> void insert(InputIt first, InputIt last) {
+		for (; first != last; ++first) {
+			emplace(*first);
+		}
+	}
+	void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+	template <class... Args> std::pair<iterator, bool> emplace(Args&&... args) {
+		using extractor = detail::key_extractor_for<Key, Args...>;
+		if constexpr (extractor::value) {
+			// ключ виден в аргументах: нода выделяется только если ключа нет
+			const Key& key = extractor::get(args...);
+			std::size_t h = hash_of(key);
+			prepare_insert();
+			auto& head = bucket_for(h);
+			if (auto* finded = find_in(head, key, h)) {
+				return {iterator(this, finded), false};
+			}
+			return {link_node(head, list_type::create_node(node_alloc, std::forward<Args>(args)...), h), true};
+		} else {
+			auto* node = list_type::create_node(node_alloc, std::forward<Args>(args)...);
+			std::size_t h = hash_of(node->value.first);
+			try {
+				prepare_insert();
+			} catch (...) {
+				list_type::destroy_node(node_alloc, node);
+				throw;
+			}
+			auto& head = bucket_for(h);
+			if (auto* finded = find_in(head, node->value.first, h)) {
+				list_type::destroy_node(node_alloc, node);
+				return {iterator(this, finded), false};
+			}
+			return {link_node(head, node, h), true};
+		}
+	}
+	template <class... Args> std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+		return try_emplace_impl(key, std::forward<Args>(args)...);
+	}
+	template <class... Args> std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+		return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+	}
+	template <class K, class... Args>
+		requires transparent_key<K>
+	std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+		return try_emplace_impl(std::forward<K>(key), std::forward<Args>(args)...);
+	}
+	template <class M> std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj) {
+		return insert_or_assign_impl(key, std::forward<M>(obj));
+	}
+	template <class M> std::pair<iterator, bool> insert_or_assign(Key&& key, M&& obj) {
+		return insert_or_assign_impl(std::move(key), std::forward<M>(obj));
+	}
+	iterator erase(const_iterator pos) {
+		auto* node = pos.current;
+		if (!node) {
+			return end();
+		}
+		auto* next = node_after(node);
+		unlink(bucket_for(node_hash(node)), node);
+		list_type::destroy_node(node_alloc, node);
+		--items_count;
+		return iterator(this, next);
+	}
+	iterator erase(iterator pos) { return erase(const_iterator(this, pos.current)); }
+	size_type erase(const Key& key) { return erase_impl(key); }
+	template <class K>
+		requires transparent_key<K>
+	size_type erase(K&& key) {
+		return erase_impl(key);
+	}
+
+	/* lookup */
+	T& operator[](const Key& key) { return try_emplace(key).first->second; }
+	T& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+	T& at(const Key& key) { return at_impl(key); }
+	const T& at(const Key& key) const { return at_impl(key); }
+	// неконстантный поиск тоже продвигает перенос, константный только читает
+	iterator find(const Key& key) {
+		migrate_step();
+		return iterator(this, find_node(key));
+	}
+	const_iterator find(const Key& key) const { return const_iterator(this, find_node(key)); }
+	template <class K>
+		requires transparent_lookup<Hash, KeyEqual>
+	iterator find(const K& key) {
+		migrate_step();
+		return iterator(this, find_node(key));
+	}
+	template <class K>
+		requires transparent_lookup<Hash, KeyEqual>
+	const_iterator find(const K& key) const {
+		return const_iterator(this, find_node(key));
+	}
+	bool contains(const Key& key) const { return find_node(key) != nullptr; }
+	template <class K>
+		requires transparent_lookup<Hash, KeyEqual>
+	bool contains(const K& key) const {
+		return find_node(key) != nullptr;
+	}
+	size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+	/* bucket interface */
+	// ведра таблицы, в которую идет перенос
+	size_type bucket_count() const noexcept { return table.count; }
+	// идет ли сейчас перенос из старой таблицы
+	bool is_rehashing() const noexcept { return old_table.heads != nullptr; }
+
+	/* hash policy */
+	float load_factor() const { return static_cast<float>(size()) / static_cast<float>(bucket_count()); }
+	float max_load_factor() const { return max_saturation; }
+	void max_load_factor(float lf) { max_saturation = lf; }
+	// явный rehash делается сразу целиком, как в HashMap
+	void rehash(size_type count) {
+		finish_rehash();
+		count = table_size_for(std::max<size_type>(count, std::ceil(size() / max_load_factor())));
+		if (count == table.count) {
+			return;
+		}
+		auto new_table = make_table(count);
+		for (size_type i = 0; i < table.count; ++i) {
+			for (auto* node = table.heads[i]; node;) {
+				auto* next = node->next;
+				auto& head = new_table.heads[node_hash(node) & new_table.mask()];
+				node->next = head;
+				head = node;
+				node = next;
+			}
+		}
+		free_table(table);
+		table = new_table;
+	}
+	void reserve(size_type count) { rehash(std::ceil(count / max_load_factor())); }
+	// дотянуть текущий перенос до конца
+	void finish_rehash() {
+		while (is_rehashing()) {
+			migrate_buckets(old_table.count);
+		}
+	}
+
+	/* observers */
+	Hash hash_function() const { return hash; }
+	KeyEqual key_eq() const { return equal; }
+
+  private:
+	template <class K> std::size_t hash_of(const K& key) const { return detail::finalize_hash<Hash>(hash(key)); }
+	std::size_t node_hash(const node_type* node) const {
+		if constexpr (cache_hash_code_v<Key, Hash>) {
+			return node->hash_code.value;
+		} else {
+			return hash_of(node->value.first);
+		}
+	}
+	static size_type table_size_for(size_type count) {
+		return std::bit_ceil(std::max<size_type>(count, INIT_BUCKET_COUNT));
+	}
+	Table make_table(size_type count, bool zeroed = true) {
+		heads_allocator alloc(node_alloc);
+		Table result{heads_traits::allocate(alloc, count), count};
+		if (zeroed) {
+			std::fill_n(result.heads, count, nullptr);
+		}
+		return result;
+	}
+	void free_table(Table& t) noexcept {
+		if (t.heads) {
+			heads_allocator alloc(node_alloc);
+			heads_traits::deallocate(alloc, t.heads, t.count);
+		}
+		t = {};
+	}
+	void destroy_nodes() noexcept {
+		auto destroy_chains = [this](Table& t, size_type from, size_type to) {
+			for (auto i = from; i < to; ++i) {
+				for (auto* node = t.heads[i]; node;) {
+					auto* next = node->next;
+					list_type::destroy_node(node_alloc, node);
+					node = next;
+				}
+			}
+		};
+		if (is_rehashing()) {
+			destroy_chains(old_table, migrated, old_table.count);
+			// в новой таблице готовы только ведра, уже принявшие перенос
+			destroy_chains(table, 0, migrated);
+			destroy_chains(table, old_table.count, old_table.count + migrated);
+		} else {
+			destroy_chains(table, 0, table.count);
+		}
+	}
+	void release() noexcept {
+		destroy_nodes();
+		free_table(old_table);
+		free_table(table);
+		migrated = 0;
+		items_count = 0;
+	}
+	void copy_values(const IncrementalHashMap& other) {
+		try {
+			for (const auto& value : other) {
+				emplace(value);
+			}
+		} catch (...) {
+			release();
+			throw;
+		}
+	}
+
+	/* перенос */
+	// ведро ключа: в старой таблице, если оно еще не перенесено, иначе в новой
+	node_type*& bucket_for(std::size_t h) {
+		if (is_rehashing()) {
+			auto index = h & old_table.mask();
+			if (index >= migrated) {
+				return old_table.heads[index];
+			}
+		}
+		return table.heads[h & table.mask()];
+	}
+	node_type* bucket_head(std::size_t h) const { return const_cast<IncrementalHashMap*>(this)->bucket_for(h); }
+	// новая таблица выделяется без обнуления: ее ведра i и i + n обнуляются при переносе ведра i
+	void start_rehash() {
+		finish_rehash();
+		old_table = table;
+		table = make_table(old_table.count * 2, false);
+		migrated = 0;
+	}
+	void migrate_buckets(size_type count) {
+		auto end = std::min(old_table.count, migrated + count);
+		for (; migrated < end; ++migrated) {
+			auto& low = table.heads[migrated];
+			auto& high = table.heads[migrated + old_table.count];
+			low = nullptr;
+			high = nullptr;
+			for (auto* node = old_table.heads[migrated]; node;) {
+				auto* next = node->next;
+				auto& head = (node_hash(node) & old_table.count) ? high : low;
+				node->next = head;
+				head = node;
+				node = next;
+			}
+		}
+		if (migrated == old_table.count) {
+			free_table(old_table);
+			migrated = 0;
+		}
+	}
+	void migrate_step() {
+		if (is_rehashing()) {
+			migrate_buckets(MIGRATE_BUCKETS);
+		}
+	}
+	void prepare_insert() {
+		if (!table.heads) {
+			// после перемещения таблицы нет
+			table = make_table(INIT_BUCKET_COUNT);
+		}
+		if (size() + 1 > max_load_factor() * bucket_count()) {
+			start_rehash();
+		}
+		migrate_step();
+	}
+
+	/* поиск */
+	template <class K> node_type* find_in(node_type* node, const K& key, std::size_t h) const {
+		for (; node; node = node->next) {
+			if constexpr (cache_hash_code_v<Key, Hash>) {
+				if (node->hash_code.value != h) {
+					continue;
+				}
+			}
+			if (equal(node->value.first, key)) {
+				return node;
+			}
+		}
+		return nullptr;
+	}
+	template <class K> node_type* find_node(const K& key) const {
+		if (!table.heads) {
+			return nullptr;
+		}
+		std::size_t h = hash_of(key);
+		return find_in(bucket_head(h), key, h);
+	}
+	template <class K> T& at_impl(const K& key) const {
+		auto* node = find_node(key);
+		if (!node) {
+			throw std::out_of_range("No value with key\n");
+		}
+		return node->value.second;
+	}
+	template <class K, class... Args> std::pair<iterator, bool> try_emplace_impl(K&& key, Args&&... args) {
+		std::size_t h = hash_of(key);
+		prepare_insert();
+		auto& head = bucket_for(h);
+		if (auto* finded = find_in(head, key, h)) {
+			return {iterator(this, finded), false};
+		}
+		auto* node = list_type::create_node(node_alloc, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		return {link_node(head, node, h), true};
+	}
+	template <class K, class M> std::pair<iterator, bool> insert_or_assign_impl(K&& key, M&& obj) {
+		auto result = try_emplace_impl(std::forward<K>(key), std::forward<M>(obj));
+		if (!result.second) {
+			result.first->second = std::forward<M>(obj);
+		}
+		return result;
+	}
+	template <class K> size_type erase_impl(const K& key) {
+		if (!table.heads) {
+			return 0;
+		}
+		migrate_step();
+		std::size_t h = hash_of(key);
+		auto& head = bucket_for(h);
+		auto* node = find_in(head, key, h);
+		if (!node) {
+			return 0;
+		}
+		unlink(head, node);
+		list_type::destroy_node(node_alloc, node);
+		--items_count;
+		return 1;
+	}
+	iterator link_node(node_type*& head, node_type* node, std::size_t h) {
+		node->hash_code.set(h);
+		node->next = head;
+		head = node;
+		++items_count;
+		return iterator(this, node);
+	}
+	static void unlink(node_type*& head, node_type* node) noexcept {
+		auto** link = &head;
+		while (*link != node) {
+			link = &(*link)->next;
+		}
+		*link = node->next;
+	}
+
+	/* обход */
+	// первая нода, начиная с ведра index старой (in_old) или новой таблицы
+	node_type* first_node_from(bool in_old, size_type index) const {
+		if (in_old) {
+			for (; index < old_table.count; ++index) {
+				if (old_table.heads[index]) {
+					return old_table.heads[index];
+				}
+			}
+			index = 0;
+		}
+		for (; index < table.count; ++index) {
+			if (is_rehashing() && (index & old_table.mask()) >= migrated) {
+				// ведра [migrated, n) и [n + migrated, 2n) новой таблицы еще не обнулены
+				if (index >= old_table.count) {
+					return nullptr;
+				}
+				index = old_table.count - 1;
+				continue;
+			}
+			if (table.heads[index]) {
+				return table.heads[index];
+			}
+		}
+		return nullptr;
+	}
+	node_type* first_node() const { return is_rehashing() ? first_node_from(true, migrated) : first_node_from(false, 0); }
+	node_type* node_after_bucket_of(const node_type* node) const {
+		auto h = node_hash(node);
+		if (is_rehashing()) {
+			auto index = h & old_table.mask();
+			if (index >= migrated) {
+				return first_node_from(true, index + 1);
+			}
+		}
+		return first_node_from(false, (h & table.mask()) + 1);
+	}
+	node_type* node_after(const node_type* node) const { return node->next ? node->next : node_after_bucket_of(node); }
+};
+} // namespace tech
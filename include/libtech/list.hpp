@@ -2,7 +2,7 @@
 #include <cstdint>
 #include <iostream>
 #include <source_location>
-#include <libtech/uniqueptr.hpp>
+#include <memory>
 
 namespace tech {
 template <class T, class Allocator = std::allocator<T>> class List {
@@ -11,26 +11,16 @@ template <class T, class Allocator = std::allocator<T>> class List {
 
 	using value_type = T;
 	struct Node {
-		tech::UniquePtr<T, std::function<void(T*)>> value;
+		T value; // значение лежит прямо в ноде, одна аллокация на элемент
 		Node* next;
 		Node* prev;
-		// Node(const T &val, Node *_prev = nullptr, Node *_next = nullptr)
-		// 	: value(val), prev(_prev), next(_next) {}
-		// Node(T &&val, Node *_prev = nullptr, Node *_next = nullptr)
-		// 	: value(std::forward<T>(val)), prev(_prev), next(_next) {}
 		template <class... Args>
 		Node(Args&&... args)
-			: value(Allocator().allocate(1), [](T* ptr){std::destroy_at(ptr); Allocator().deallocate(ptr, 1);}), next(nullptr),
-			  prev(nullptr) {
-				std::construct_at(value.get(), std::forward<Args>(args)...);
-				}
-		// Node(const Node& node)
-		// 	: value(node.value), next(node.next), prev(node.next) {}
-		// template <class... Args>
-		// Node(const Args &...args, Node *_prev = nullptr, Node *_next =
-		// nullptr) 	: value(args...), prev(_prev), next(_next) {}
+			: value(std::forward<Args>(args)...), next(nullptr), prev(nullptr) {}
 	};
 	using node_type = Node;
+	using allocator_type = Allocator;
+	using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
 	template <class ValueType> class Iterator {
 	  protected:
 		
@@ -43,8 +33,8 @@ template <class T, class Allocator = std::allocator<T>> class List {
 		using reference = ValueType&;
 		using iterator_category = std::bidirectional_iterator_tag;
 		explicit Iterator(Node* ptr) : current(ptr) {}
-		reference operator*() { return *(current->value); }
-		pointer operator->() { return current->value; }
+		reference operator*() { return current->value; }
+		pointer operator->() { return &current->value; }
 		bool operator==(const Iterator& another) const {
 			return current == another.current;
 		}
@@ -60,7 +50,7 @@ template <class T, class Allocator = std::allocator<T>> class List {
 			return old;
 		}
 		Iterator& operator--() {
-			if (current->value) {
+			if (current) {
 				current = current->prev;
 			}
 			return *this;
@@ -115,34 +105,50 @@ template <class T, class Allocator = std::allocator<T>> class List {
 	};
 
 	/* constructors*/
-	List() : first(nullptr), last(nullptr) {
-		first = nullptr;
-		last = nullptr;
-		count = 0;
-	}
+	List() : List(Allocator()) {}
+	explicit List(const Allocator& allocator) : alloc(allocator) {}
 	// List(std::initializer_list<value_type> init) {}
 
 	/* rule of 5 */
-	List(const List& list) {
+	List(const List& list)
+		: alloc(node_traits::select_on_container_copy_construction(list.alloc)) {
 		for (const auto& item : list) {
 			push_back(item);
 		}
 	}
 	List(List&& list) noexcept
-		: first(list.first), last(list.last), count(list.count) {
+		: first(list.first), last(list.last), count(list.count), alloc(std::move(list.alloc)) {
 		list.first = nullptr;
 		list.last = nullptr;
 		list.count = 0;
 	}
 	List& operator=(const List& list) {
+		if (this == &list) {
+			return *this;
+		}
 		clear();
-		for (const auto item : list) {
+		if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+			alloc = list.alloc;
+		}
+		for (const auto& item : list) {
 			push_back(item);
 		}
 		return *this;
 	}
 	List& operator=(List&& list) {
+		if (this == &list) {
+			return *this;
+		}
 		clear();
+		if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+			alloc = std::move(list.alloc);
+		} else if (alloc != list.alloc) {
+			for (auto& item : list) {
+				push_back(std::move(item));
+			}
+			list.clear();
+			return *this;
+		}
 		first = list.first;
 		last = list.last;
 		count = list.count;
@@ -153,9 +159,11 @@ template <class T, class Allocator = std::allocator<T>> class List {
 	}
 	~List() { clear(); }
 
+	allocator_type get_allocator() const noexcept { return allocator_type(alloc); }
+
 	/* element access */
-	T& front() { return *(first->value); };
-	T& back() { return *(last->value); }
+	T& front() { return first->value; };
+	T& back() { return last->value; }
 
 	/* iterators */
 	Iterator<T> begin() noexcept { return Iterator<T>(first); }
@@ -185,8 +193,7 @@ template <class T, class Allocator = std::allocator<T>> class List {
 		auto current = first;
 		while (current) {
 			auto next = current->next;
-			std::destroy_at((current));
-			std::allocator<Node>().deallocate(current, 1);
+			destroy_node(current);
 			if (current == last) {
 				break;
 			}
@@ -196,14 +203,10 @@ template <class T, class Allocator = std::allocator<T>> class List {
 		last = nullptr;
 	}
 	Node* push_back(const T& value) {
-		Node* node = std::allocator<Node>().allocate(1);
-		std::construct_at((node), value);
-		return push_back(node);
+		return push_back(create_node(value));
 	}
 	Node* push_back(T&& value) {
-		Node* node = std::allocator<Node>().allocate(1);
-		std::construct_at((node), std::forward<T>(value));
-		return push_back(node);
+		return push_back(create_node(std::forward<T>(value)));
 	}
 	Node* push_back(Node* node) {
 		if (first == nullptr) {
@@ -219,9 +222,7 @@ template <class T, class Allocator = std::allocator<T>> class List {
 		return node;
 	}
 	template <class... Args> Node* emplace_back(Args&&... args) {
-		Node* node = std::allocator<Node>().allocate(1);
-		std::construct_at((node), std::forward<Args>(args)...);
-		return push_back(node);
+		return push_back(create_node(std::forward<Args>(args)...));
 	}
 	// template <class... Args> Node* emplace_back(const Args&... args) {
 	// 	Node* node = new Node(args...);
@@ -242,14 +243,13 @@ template <class T, class Allocator = std::allocator<T>> class List {
 		} else {
 			last = prev;
 		}
+		--count;
 		if (returning_node) {
 			return node;
 		} else {
-			std::destroy_at(node);
-			std::allocator<Node>().deallocate(node, 1);
+			destroy_node(node);
 			return nullptr;
 		}
-		--count;
 	}
 	Iterator<T> erase(Iterator<T> pos) {
 		auto* node = pos.current;
@@ -265,22 +265,37 @@ template <class T, class Allocator = std::allocator<T>> class List {
 		} else {
 			last = prev;
 		}
-		std::destroy_at(node);
-		std::allocator<Node>().deallocate(node, 1);
+		destroy_node(node);
 		--count;
 		return Iterator<T>(next);
 	}
 	void pop_front() {
 		auto next = first->next;
-		std::destroy_at((first));
-		std::allocator<Node>().deallocate(first, 1);
+		destroy_node(first);
 		first = next;
 		count--;
 	}
 
   private:
+	using node_traits = std::allocator_traits<node_allocator>;
 	Node* first = nullptr;
 	Node* last = nullptr;
 	std::size_t count = 0;
+	[[no_unique_address]] node_allocator alloc;
+
+	template <class... Args> Node* create_node(Args&&... args) {
+		Node* node = node_traits::allocate(alloc, 1);
+		try {
+			std::construct_at(node, std::forward<Args>(args)...);
+		} catch (...) {
+			node_traits::deallocate(alloc, node, 1);
+			throw;
+		}
+		return node;
+	}
+	void destroy_node(Node* node) noexcept {
+		std::destroy_at(node);
+		node_traits::deallocate(alloc, node, 1);
+	}
 };
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <libtech/execution.hpp>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tech {
+// карта, которую можно резать по ведрам: HashMap и все, у кого есть bucket_range
+template <class Map>
+concept bucket_splittable = requires(Map& map, std::size_t index) {
+	{ map.bucket_count() } -> std::convertible_to<std::size_t>;
+	map.bucket_range(index, index);
+};
+
+namespace detail {
+// кусков в несколько раз больше потоков, чтобы было что разбирать, когда ведра неравные.
+// Кусок кратен 64 ведрам - одному слову битмапа непустых ведер
+inline constexpr const std::size_t CHUNKS_PER_THREAD = 16;
+inline constexpr const std::size_t MIN_CHUNK_BUCKETS = 64;
+
+inline std::size_t chunk_buckets(std::size_t parts, std::size_t buckets) {
+	auto chunk = buckets / (parts * CHUNKS_PER_THREAD);
+	return std::max(MIN_CHUNK_BUCKETS, (chunk + MIN_CHUNK_BUCKETS - 1) / MIN_CHUNK_BUCKETS * MIN_CHUNK_BUCKETS);
+}
+} // namespace detail
+
+// fn(value) для каждого элемента, ведра раздаются потокам кусками. fn вызывается
+// одновременно из разных потоков, менять саму карту из нее нельзя
+template <class ExecutionPolicy, bucket_splittable Map, class F>
+	requires execution::is_execution_policy_v<ExecutionPolicy>
+void parallel_for_each(ExecutionPolicy&& exec, Map& map, F fn) {
+	auto parts = detail::parts_for(exec, map.size());
+	auto buckets = map.bucket_count();
+	detail::run_chunks(parts, buckets, detail::chunk_buckets(parts, buckets),
+					   [&](std::size_t /*part*/, std::size_t begin, std::size_t end) {
+						   for (auto& value : map.bucket_range(begin, end)) {
+							   fn(value);
+						   }
+					   });
+}
+template <bucket_splittable Map, class F> void parallel_for_each(Map& map, F fn) {
+	parallel_for_each(execution::par, map, std::move(fn));
+}
+
+// у каждого потока свой частичный результат: он начинается с T{}, копит op(acc, value),
+// в конце init и частичные складываются combine. init входит в результат ровно один раз,
+// как в std::reduce, а T{} должен быть нейтральным для combine (0 для суммы, пустой контейнер)
+template <class ExecutionPolicy, bucket_splittable Map, class T, class Op, class Combine = std::plus<>>
+	requires execution::is_execution_policy_v<ExecutionPolicy>
+T parallel_reduce(ExecutionPolicy&& exec, const Map& map, T init, Op op, Combine combine = Combine()) {
+	auto parts = detail::parts_for(exec, map.size());
+	auto buckets = map.bucket_count();
+	// поток, которому не досталось кусков, в результат ничего не добавляет
+	std::vector<std::optional<T>> partials(parts);
+	detail::run_chunks(parts, buckets, detail::chunk_buckets(parts, buckets),
+					   [&](std::size_t part, std::size_t begin, std::size_t end) {
+						   // копим в локальной переменной: соседние partials на одной кеш-линии
+						   auto acc = partials[part] ? std::move(*partials[part]) : T{};
+						   for (const auto& value : map.bucket_range(begin, end)) {
+							   acc = op(std::move(acc), value);
+						   }
+						   partials[part] = std::move(acc);
+					   });
+	auto result = std::move(init);
+	for (auto& partial : partials) {
+		if (partial) {
+			result = combine(std::move(result), std::move(*partial));
+		}
+	}
+	return result;
+}
+template <bucket_splittable Map, class T, class Op, class Combine = std::plus<>>
+T parallel_reduce(const Map& map, T init, Op op, Combine combine = Combine()) {
+	return parallel_reduce(execution::par, map, std::move(init), std::move(op), std::move(combine));
+}
+} // namespace tech
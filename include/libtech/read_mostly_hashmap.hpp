@@ -0,0 +1,410 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <libtech/epoch.hpp>
+#include <libtech/execution.hpp>
+#include <libtech/hash.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tech {
+// карта для чтения из многих потоков: цепочки как в HashMap, но читатель идет по ним
+// без блокировок и без записи в общую память, только закрепив эпоху EpochDomain.
+// Писатели блокируют полосу ведер (ведро i - полоса i % LOCK_STRIPES), значение
+// в ноде не меняется: новое значение - новая нода на месте старой, старая освобождается
+// через эпохи. Рост таблицы перецепляет ноды в новую таблицу под всеми полосами;
+// читатель, промахнувшийся во время роста, повторяет поиск
+template <class Key, class T, class Hash = tech::Hash<Key>, class KeyEqual = std::equal_to<Key>,
+		  class Allocator = std::allocator<std::pair<Key, T>>>
+class ReadMostlyHashMap {
+	static_assert(is_concurrent_allocator<Allocator>::value, "nodes are allocated from several threads");
+
+  public:
+	using size_type = std::size_t;
+	using value_type = std::pair<Key, T>;
+	using key_type = Key;
+	using mapped_type = T;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using allocator_type = Allocator;
+
+	static constexpr const size_type LOCK_STRIPES = 64;
+
+  private:
+	struct Node {
+		template <class... Args>
+		explicit Node(std::size_t h, Args&&... args) : hash(h), value(std::forward<Args>(args)...) {}
+		std::atomic<Node*> next{nullptr};
+		const std::size_t hash;
+		const value_type value;
+	};
+	using head_type = std::atomic<Node*>;
+	// ведер степень двойки и не меньше полос: полоса ведра определяется хешем, а не таблицей
+	struct Table {
+		size_type count;
+		head_type* heads;
+	};
+	struct alignas(64) Stripe {
+		std::mutex mutex;
+	};
+	// вынутое из структуры и эпоха, после которой его можно освободить
+	struct Retired {
+		std::uint64_t epoch;
+		Node* node;
+		Table* table;
+	};
+	static constexpr const size_type RECLAIM_BATCH = 64;
+
+	using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+	using node_traits = std::allocator_traits<node_allocator>;
+	using heads_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<head_type>;
+	using heads_traits = std::allocator_traits<heads_allocator>;
+	using table_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Table>;
+	using table_traits = std::allocator_traits<table_allocator>;
+
+	[[no_unique_address]] node_allocator node_alloc;
+	std::atomic<Table*> table{nullptr};
+	// нечетный - идет перецепление нод в новую таблицу
+	std::atomic<std::uint64_t> resize_seq{0};
+	std::atomic<size_type> items_count{0};
+	std::unique_ptr<Stripe[]> stripes;
+	std::mutex retire_mutex;
+	std::vector<Retired> retired;
+	Hash hash;
+	[[no_unique_address]] KeyEqual equal;
+
+  public:
+	/* constructors */
+	explicit ReadMostlyHashMap(size_type bucket_count = LOCK_STRIPES, const Hash& _hash = Hash(),
+							   const KeyEqual& _equal = KeyEqual(), const Allocator& alloc = Allocator())
+		: node_alloc(alloc), stripes(std::make_unique<Stripe[]>(LOCK_STRIPES)), hash(_hash), equal(_equal) {
+		table.store(make_table(table_size_for(bucket_count)), std::memory_order_relaxed);
+	}
+	ReadMostlyHashMap(const ReadMostlyHashMap&) = delete;
+	ReadMostlyHashMap& operator=(const ReadMostlyHashMap&) = delete;
+	// читателей и писателей к этому моменту быть не должно
+	~ReadMostlyHashMap() {
+		auto* current = table.load(std::memory_order_relaxed);
+		for (size_type i = 0; i < current->count; ++i) {
+			for (auto* node = current->heads[i].load(std::memory_order_relaxed); node;) {
+				destroy_node(std::exchange(node, node->next.load(std::memory_order_relaxed)));
+			}
+		}
+		destroy_table(current);
+		for (auto& item : retired) {
+			free_retired(item);
+		}
+	}
+
+	allocator_type get_allocator() const noexcept { return allocator_type(node_alloc); }
+
+	/* capacity */
+	// при параллельных вставках это лишь оценка
+	size_type size() const noexcept { return items_count.load(std::memory_order_relaxed); }
+	bool empty() const noexcept { return size() == 0; }
+	size_type bucket_count() const noexcept { return table.load(std::memory_order_acquire)->count; }
+
+	/* modifiers */
+	bool insert(const value_type& value) { return emplace(value.first, value.second); }
+	bool insert(value_type&& value) { return emplace(std::move(value.first), std::move(value.second)); }
+	// как try_emplace: при существующем ключе аргументы не трогаются
+	template <class K, class... Args>
+	bool emplace(K&& key, Args&&... args) {
+		std::size_t h = hash_of(key);
+		std::unique_lock lock(stripe_for(h).mutex);
+		auto* current = table.load(std::memory_order_relaxed);
+		auto& head = current->heads[h & (current->count - 1)];
+		if (find_locked(head, key, h).node) {
+			return false;
+		}
+		auto* node = create_node(h, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+								 std::forward_as_tuple(std::forward<Args>(args)...));
+		link_front(head, node);
+		lock.unlock();
+		grow_if_needed(current);
+		return true;
+	}
+	// возвращает true при вставке, иначе значение заменено новой нодой
+	template <class K, class M>
+	bool insert_or_assign(K&& key, M&& obj) {
+		std::size_t h = hash_of(key);
+		std::unique_lock lock(stripe_for(h).mutex);
+		auto* current = table.load(std::memory_order_relaxed);
+		auto& head = current->heads[h & (current->count - 1)];
+		auto found = find_locked(head, key, h);
+		auto* node = create_node(h, std::forward<K>(key), std::forward<M>(obj));
+		if (found.node) {
+			replace(*found.link, found.node, node);
+			return false;
+		}
+		link_front(head, node);
+		lock.unlock();
+		grow_if_needed(current);
+		return true;
+	}
+	// если ключ есть, fn(T&) применяется к копии значения, и копия заменяет ноду.
+	// Если нет, вставляется T(args...). Возвращает true при вставке
+	template <class K, class F, class... Args>
+	bool upsert(K&& key, F&& fn, Args&&... args) {
+		std::size_t h = hash_of(key);
+		std::unique_lock lock(stripe_for(h).mutex);
+		auto* current = table.load(std::memory_order_relaxed);
+		auto& head = current->heads[h & (current->count - 1)];
+		auto found = find_locked(head, key, h);
+		if (found.node) {
+			T value = found.node->value.second;
+			std::invoke(std::forward<F>(fn), value);
+			replace(*found.link, found.node, create_node(h, found.node->value.first, std::move(value)));
+			return false;
+		}
+		auto* node = create_node(h, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+								 std::forward_as_tuple(std::forward<Args>(args)...));
+		link_front(head, node);
+		lock.unlock();
+		grow_if_needed(current);
+		return true;
+	}
+	size_type erase(const Key& key) {
+		std::size_t h = hash_of(key);
+		std::lock_guard lock(stripe_for(h).mutex);
+		auto* current = table.load(std::memory_order_relaxed);
+		auto found = find_locked(current->heads[h & (current->count - 1)], key, h);
+		if (!found.node) {
+			return 0;
+		}
+		// читатель, стоящий на ноде, дойдет по ее next до конца цепочки
+		found.link->store(found.node->next.load(std::memory_order_relaxed), std::memory_order_release);
+		items_count.fetch_sub(1, std::memory_order_relaxed);
+		retire(found.node, nullptr);
+		return 1;
+	}
+	void clear() {
+		auto locks = lock_all();
+		auto* current = table.load(std::memory_order_relaxed);
+		table.store(make_table(LOCK_STRIPES), std::memory_order_release);
+		items_count.store(0, std::memory_order_relaxed);
+		for (size_type i = 0; i < current->count; ++i) {
+			for (auto* node = current->heads[i].load(std::memory_order_relaxed); node;
+				 node = node->next.load(std::memory_order_relaxed)) {
+				retire(node, nullptr);
+			}
+		}
+		retire(nullptr, current);
+	}
+	void reserve(size_type count) {
+		auto locks = lock_all();
+		auto needed = table_size_for(count);
+		if (needed > table.load(std::memory_order_relaxed)->count) {
+			relink(needed);
+		}
+	}
+
+	/* lookup */
+	// fn(const T&) под закрепленной эпохой: нода не освободится, пока fn работает
+	template <class F>
+	bool visit(const Key& key, F&& fn) const {
+		auto guard = EpochDomain::global().pin();
+		auto* node = find_node(key);
+		if (!node) {
+			return false;
+		}
+		std::invoke(std::forward<F>(fn), node->value.second);
+		return true;
+	}
+	std::optional<T> find(const Key& key) const {
+		auto guard = EpochDomain::global().pin();
+		auto* node = find_node(key);
+		if (!node) {
+			return std::nullopt;
+		}
+		return node->value.second;
+	}
+	bool contains(const Key& key) const {
+		auto guard = EpochDomain::global().pin();
+		return find_node(key) != nullptr;
+	}
+	size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+	/* visitors */
+	// обход под всеми полосами: писатели ждут, читатели нет
+	template <class F>
+	void for_each(F&& fn) const {
+		auto locks = lock_all();
+		auto* current = table.load(std::memory_order_relaxed);
+		for (size_type i = 0; i < current->count; ++i) {
+			for (auto* node = current->heads[i].load(std::memory_order_relaxed); node;
+				 node = node->next.load(std::memory_order_relaxed)) {
+				fn(node->value);
+			}
+		}
+	}
+
+	/* observers */
+	Hash hash_function() const { return hash; }
+	KeyEqual key_eq() const { return equal; }
+
+  private:
+	template <class K> std::size_t hash_of(const K& key) const { return detail::finalize_hash<Hash>(hash(key)); }
+	Stripe& stripe_for(std::size_t h) const { return stripes[h & (LOCK_STRIPES - 1)]; }
+	static size_type table_size_for(size_type count) {
+		return std::bit_ceil(std::max(count, LOCK_STRIPES));
+	}
+	// полосы берутся всегда по порядку, так что два lock_all не ждут друг друга по кругу
+	std::unique_ptr<std::unique_lock<std::mutex>[]> lock_all() const {
+		auto locks = std::make_unique<std::unique_lock<std::mutex>[]>(LOCK_STRIPES);
+		for (size_type i = 0; i < LOCK_STRIPES; ++i) {
+			locks[i] = std::unique_lock(stripes[i].mutex);
+		}
+		return locks;
+	}
+
+	// поиск без блокировок. Промах во время роста или после него повторяется:
+	// нода могла уйти в новую таблицу, пока мы шли по старой цепочке
+	template <class K>
+	Node* find_node(const K& key) const {
+		std::size_t h = hash_of(key);
+		while (true) {
+			auto seq = resize_seq.load(std::memory_order_acquire);
+			auto* current = table.load(std::memory_order_acquire);
+			for (auto* node = current->heads[h & (current->count - 1)].load(std::memory_order_acquire); node;
+				 node = node->next.load(std::memory_order_acquire)) {
+				if (node->hash == h && equal(node->value.first, key)) {
+					return node;
+				}
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if ((seq & 1) == 0 && resize_seq.load(std::memory_order_relaxed) == seq) {
+				return nullptr;
+			}
+			std::this_thread::yield();
+		}
+	}
+	struct Found {
+		head_type* link;
+		Node* node;
+	};
+	// под блокировкой полосы: link - указатель, который ведет на найденную ноду
+	template <class K>
+	Found find_locked(head_type& head, const K& key, std::size_t h) const {
+		head_type* link = &head;
+		for (auto* node = link->load(std::memory_order_relaxed); node; node = link->load(std::memory_order_relaxed)) {
+			if (node->hash == h && equal(node->value.first, key)) {
+				return {link, node};
+			}
+			link = &node->next;
+		}
+		return {link, nullptr};
+	}
+	void link_front(head_type& head, Node* node) {
+		node->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		head.store(node, std::memory_order_release);
+		items_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	void replace(head_type& link, Node* old_node, Node* node) {
+		node->next.store(old_node->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		link.store(node, std::memory_order_release);
+		retire(old_node, nullptr);
+	}
+
+	void grow_if_needed(Table* seen) {
+		if (size() <= seen->count) {
+			return;
+		}
+		auto locks = lock_all();
+		// таблицу мог уже увеличить другой писатель
+		auto* current = table.load(std::memory_order_relaxed);
+		if (current == seen && size() > current->count) {
+			relink(current->count * 2);
+		}
+	}
+	// под всеми полосами. Ноды не копируются: каждая перецепляется в голову своего ведра
+	// новой таблицы. Читатель на перецепленной ноде дойдет до конца новой цепочки, а про промах
+	// узнает по resize_seq
+	void relink(size_type count) {
+		auto* old_table = table.load(std::memory_order_relaxed);
+		auto* new_table = make_table(count);
+		auto seq = resize_seq.load(std::memory_order_relaxed);
+		resize_seq.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (size_type i = 0; i < old_table->count; ++i) {
+			for (auto* node = old_table->heads[i].load(std::memory_order_relaxed); node;) {
+				auto* next = node->next.load(std::memory_order_relaxed);
+				auto& head = new_table->heads[node->hash & (count - 1)];
+				node->next.store(head.load(std::memory_order_relaxed), std::memory_order_release);
+				head.store(node, std::memory_order_relaxed);
+				node = next;
+			}
+		}
+		table.store(new_table, std::memory_order_release);
+		resize_seq.store(seq + 2, std::memory_order_release);
+		retire(nullptr, old_table);
+	}
+
+	/* memory */
+	template <class... Args>
+	Node* create_node(std::size_t h, Args&&... args) {
+		auto* node = node_traits::allocate(node_alloc, 1);
+		try {
+			node_traits::construct(node_alloc, node, h, std::forward<Args>(args)...);
+		} catch (...) {
+			node_traits::deallocate(node_alloc, node, 1);
+			throw;
+		}
+		return node;
+	}
+	void destroy_node(Node* node) {
+		node_traits::destroy(node_alloc, node);
+		node_traits::deallocate(node_alloc, node, 1);
+	}
+	Table* make_table(size_type count) {
+		heads_allocator heads_alloc(node_alloc);
+		table_allocator table_alloc(node_alloc);
+		auto* heads = heads_traits::allocate(heads_alloc, count);
+		for (size_type i = 0; i < count; ++i) {
+			heads_traits::construct(heads_alloc, heads + i, nullptr);
+		}
+		auto* result = table_traits::allocate(table_alloc, 1);
+		table_traits::construct(table_alloc, result, Table{count, heads});
+		return result;
+	}
+	void destroy_table(Table* old_table) {
+		heads_allocator heads_alloc(node_alloc);
+		table_allocator table_alloc(node_alloc);
+		heads_traits::deallocate(heads_alloc, old_table->heads, old_table->count);
+		table_traits::deallocate(table_alloc, old_table, 1);
+	}
+	void free_retired(const Retired& item) {
+		if (item.node) {
+			destroy_node(item.node);
+		} else {
+			destroy_table(item.table);
+		}
+	}
+	// эпоха читается под retire_mutex, так что список упорядочен по ней
+	void retire(Node* node, Table* old_table) {
+		// отцепление видно раньше, чем прочитана эпоха: пара к барьеру в EpochDomain::pin
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		std::lock_guard lock(retire_mutex);
+		auto& domain = EpochDomain::global();
+		retired.push_back({domain.current(), node, old_table});
+		if (retired.size() % RECLAIM_BATCH != 0) {
+			return;
+		}
+		auto current_epoch = domain.try_advance();
+		auto safe = std::find_if(retired.begin(), retired.end(), [&](const Retired& item) {
+			return !EpochDomain::is_safe(item.epoch, current_epoch);
+		});
+		std::for_each(retired.begin(), safe, [&](const Retired& item) { free_retired(item); });
+		retired.erase(retired.begin(), safe);
+	}
+};
+} // namespace tech
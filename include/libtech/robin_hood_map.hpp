@@ -0,0 +1,576 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <libtech/hash.hpp>
+#include <libtech/hash_traits.hpp>
+#include <libtech/vector.hpp>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace tech {
+namespace detail {
+// дистанция от дома хранится в байте как d + 1, 0 - пустой слот
+inline constexpr const std::size_t ROBIN_HOOD_MAX_DISTANCE = 255;
+} // namespace detail
+
+// открытая адресация с линейным пробированием и правилом Robin Hood: новый элемент вытесняет
+// того, кто ближе к своему дому. Дистанции в таблице выровнены, поиск отсутствующего ключа
+// останавливается, как только встречен элемент ближе к дому, чем искомый был бы на этом месте.
+// Удаление сдвигает хвост назад вместо надгробий. Держит заполнение до 0.95.
+// За последним ведром есть запас слотов: пробирование не заворачивает в начало, а упершись в конец -
+// растит таблицу
+template <class Key, class T, class Hash = tech::Hash<Key>, class KeyEqual = std::equal_to<Key>, class Allocator = std::allocator<std::pair<Key, T>>> class RobinHoodMap {
+  public:
+	using size_type = std::size_t;
+	using value_type = std::pair<Key, T>;
+	using key_type = Key;
+	using mapped_type = T;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using allocator_type = Allocator;
+
+  private:
+	// сырая память под пару, живые значения отмечены ненулевой дистанцией
+	struct Slot {
+		alignas(value_type) std::byte storage[sizeof(value_type)];
+		value_type& value() { return *std::launder(reinterpret_cast<value_type*>(storage)); }
+		const value_type& value() const {
+			return *std::launder(reinterpret_cast<const value_type*>(storage));
+		}
+		value_type* raw() { return reinterpret_cast<value_type*>(storage); }
+	};
+	using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+	using dist_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::uint8_t>;
+	using slots_type = Vector<Slot, slot_allocator>;
+	using dist_type = Vector<std::uint8_t, dist_allocator>;
+	using alloc_traits = std::allocator_traits<Allocator>;
+
+	static constexpr const std::size_t INIT_CAPACITY = 16;
+	static constexpr const float DEFAULT_MAX_LOAD_FACTOR = 0.9;
+	[[no_unique_address]] Allocator alloc;
+	slots_type slots;
+	// на один больше слотов: последний всегда 0 и останавливает поиск и сдвиги
+	dist_type dist;
+	Hash hash;
+	[[no_unique_address]] KeyEqual equal;
+	size_type items_count = 0;
+	size_type mask = 0;
+	float max_saturation = DEFAULT_MAX_LOAD_FACTOR;
+
+  public:
+	template <class ValueType, class MapType> class Iterator {
+	  public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = ValueType;
+		using pointer = ValueType*;
+		using reference = ValueType&;
+		using iterator_category = std::forward_iterator_tag;
+		friend class RobinHoodMap;
+
+	  private:
+		MapType* map;
+		size_type index;
+		void skip_free() {
+			while (index < map->slot_count() && map->dist[index] == 0) {
+				++index;
+			}
+		}
+
+	  public:
+		Iterator(MapType* ptr, size_type pos) : map(ptr), index(pos) {}
+		reference operator*() const { return map->slots[index].value(); }
+		pointer operator->() const { return &map->slots[index].value(); }
+		bool operator==(const Iterator& another) const {
+			return index == another.index;
+		}
+		Iterator& operator++() {
+			++index;
+			skip_free();
+			return *this;
+		}
+		Iterator operator++(int) {
+			auto old = *this;
+			++(*this);
+			return old;
+		}
+	};
+	using iterator = Iterator<value_type, RobinHoodMap>;
+	using const_iterator = Iterator<const value_type, const RobinHoodMap>;
+
+  private:
+	// для erase и try_emplace K не должен путаться с итератором
+	template <class K>
+	static constexpr bool transparent_key = transparent_lookup<Hash, KeyEqual> &&
+		!std::is_convertible_v<K, iterator> && !std::is_convertible_v<K, const_iterator>;
+
+  public:
+	/* constructors */
+	RobinHoodMap() : RobinHoodMap(Allocator()) {}
+	explicit RobinHoodMap(const Allocator& allocator)
+		: alloc(allocator), slots(alloc), dist(alloc), hash({}) {
+		init_slots(INIT_CAPACITY);
+	}
+	template <class InputIt>
+	RobinHoodMap(InputIt first, InputIt last, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& allocator = Allocator())
+		: alloc(allocator), slots(alloc), dist(alloc), hash(_hash), equal(_equal) {
+		init_slots(capacity_for(std::max<size_type>(buckets_count, std::ceil(std::distance(first, last) / max_load_factor()))));
+		insert(first, last);
+	}
+	RobinHoodMap(std::initializer_list<value_type> init, size_type buckets_count = 1, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& allocator = Allocator())
+		: RobinHoodMap(init.begin(), init.end(), buckets_count, _hash, _equal, allocator) {}
+	explicit RobinHoodMap(size_type buckets_count, const Hash& _hash = Hash(), const KeyEqual& _equal = KeyEqual(), const Allocator& allocator = Allocator())
+		: alloc(allocator), slots(alloc), dist(alloc), hash(_hash), equal(_equal) {
+		init_slots(capacity_for(buckets_count));
+	}
+
+	/* rule of 5 */
+	RobinHoodMap(const RobinHoodMap& other)
+		: alloc(alloc_traits::select_on_container_copy_construction(other.alloc)),
+		  slots(alloc), dist(alloc), hash(other.hash_function()), equal(other.key_eq()), max_saturation(other.max_saturation) {
+		init_slots(other.bucket_count());
+		for (const auto& value : other) {
+			emplace(value);
+		}
+	}
+	RobinHoodMap(RobinHoodMap&& other) noexcept
+		: alloc(std::move(other.alloc)), slots(std::move(other.slots)), dist(std::move(other.dist)),
+		  hash(std::move(other.hash)), equal(std::move(other.equal)), items_count(other.items_count),
+		  mask(other.mask), max_saturation(other.max_saturation) {
+		other.items_count = 0;
+		other.mask = 0;
+	}
+	RobinHoodMap& operator=(const RobinHoodMap& other) {
+		if (this == &other) {
+			return *this;
+		}
+		destroy_values();
+		if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+			alloc = other.alloc;
+		}
+		hash = other.hash;
+		equal = other.equal;
+		max_saturation = other.max_saturation;
+		items_count = 0;
+		init_slots(other.bucket_count());
+		for (const auto& value : other) {
+			emplace(value);
+		}
+		return *this;
+	}
+	RobinHoodMap& operator=(RobinHoodMap&& other) {
+		if (this == &other) {
+			return *this;
+		}
+		destroy_values();
+		hash = std::move(other.hash);
+		equal = std::move(other.equal);
+		max_saturation = other.max_saturation;
+		if constexpr (!alloc_traits::propagate_on_container_move_assignment::value) {
+			if (alloc != other.alloc) {
+				// слоты чужого аллокатора забрать нельзя, переносим значения
+				items_count = 0;
+				init_slots(other.bucket_count());
+				for (auto& value : other) {
+					emplace(std::move(value));
+				}
+				other.clear();
+				return *this;
+			}
+		} else {
+			alloc = std::move(other.alloc);
+		}
+		slots = std::move(other.slots);
+		dist = std::move(other.dist);
+		items_count = other.items_count;
+		mask = other.mask;
+		other.items_count = 0;
+		other.mask = 0;
+		return *this;
+	}
+
+	allocator_type get_allocator() const noexcept { return alloc; }
+	~RobinHoodMap() { destroy_values(); }
+
+	/* iterators */
+	iterator begin() noexcept {
+		iterator it(this, 0);
+		it.skip_free();
+		return it;
+	}
+	iterator end() noexcept { return iterator(this, slot_count()); }
+	const_iterator begin() const noexcept {
+		const_iterator it(this, 0);
+		it.skip_free();
+		return it;
+	}
+	const_iterator end() const noexcept { return const_iterator(this, slot_count()); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+
+	/* capacity */
+	size_type size() const noexcept { return items_count; }
+	bool empty() const noexcept { return size() == 0; }
+
+	/* modifiers */
+	void clear() noexcept {
+		destroy_values();
+		std::fill_n(dist.data(), slot_count(), std::uint8_t(0));
+		items_count = 0;
+	}
+	std::pair<iterator, bool> insert(const value_type& value) {
+		return emplace(value);
+	}
+	std::pair<iterator, bool> insert(value_type&& value) {
+		return emplace(std::move(value));
+	}
+	template <class InputIt>
+	void insert(InputIt first, InputIt last) {
+		for (auto it = first; it != last; ++it) {
+			insert(*it);
+		}
+	}
+	// на место удаленного сдвигается следующий элемент, его итератор и возвращается
+	iterator erase(iterator pos) {
+		if (pos == end()) {
+			return end();
+		}
+		erase_slot(pos.index);
+		pos.skip_free();
+		return pos;
+	}
+	template <class... Args>
+	std::pair<iterator, bool> emplace(Args&&... args) {
+		using extractor = detail::key_extractor_for<Key, Args...>;
+		if constexpr (extractor::value) {
+			// ключ виден в аргументах, пара строится сразу в слоте и только если ключа нет
+			const Key& key = extractor::get(args...);
+			auto [pos, found] = find_or_prepare(key, hash_of(key));
+			if (!found) {
+				construct_slot(pos, std::forward<Args>(args)...);
+			}
+			return {iterator(this, pos), !found};
+		} else {
+			// ключ надо откуда-то взять, поэтому пара строится заранее и потом перемещается в слот
+			value_type value(std::forward<Args>(args)...);
+			auto h = hash_of(value.first);
+			auto [pos, found] = find_or_prepare(value.first, h);
+			if (!found) {
+				construct_slot(pos, std::move(value));
+			}
+			return {iterator(this, pos), !found};
+		}
+	}
+	template <class... Args>
+	iterator emplace_hint(const_iterator /*hint*/, Args&&... args) {
+		return emplace(std::forward<Args>(args)...).first;
+	}
+	template <class... Args>
+	std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+		return try_emplace_impl(key, std::forward<Args>(args)...);
+	}
+	template <class... Args>
+	std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+		return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+	}
+	template <class K, class... Args> requires transparent_key<K>
+	std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+		return try_emplace_impl(std::forward<K>(key), std::forward<Args>(args)...);
+	}
+	template <class M>
+	std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj) {
+		return insert_or_assign_impl(key, std::forward<M>(obj));
+	}
+	template <class M>
+	std::pair<iterator, bool> insert_or_assign(Key&& key, M&& obj) {
+		return insert_or_assign_impl(std::move(key), std::forward<M>(obj));
+	}
+	template <class K, class M> requires transparent_key<K>
+	std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj) {
+		return insert_or_assign_impl(std::forward<K>(key), std::forward<M>(obj));
+	}
+	size_type erase(const Key& key) { return erase_impl(key); }
+	template <class K> requires transparent_key<K>
+	size_type erase(K&& key) { return erase_impl(key); }
+
+	/* lookup */
+	T& operator[](const Key& key) { return try_emplace(key).first->second; }
+	T& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+	template <class K> requires transparent_key<K>
+	T& operator[](K&& key) { return try_emplace(std::forward<K>(key)).first->second; }
+	T& at(const Key& key) { return slots[at_index(key)].value().second; }
+	const T& at(const Key& key) const { return slots[at_index(key)].value().second; }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	T& at(const K& key) { return slots[at_index(key)].value().second; }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	const T& at(const K& key) const { return slots[at_index(key)].value().second; }
+	size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+	iterator find(const Key& key) { return iterator(this, find_index(key, hash_of(key))); }
+	const_iterator find(const Key& key) const {
+		return const_iterator(this, find_index(key, hash_of(key)));
+	}
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	iterator find(const K& key) { return iterator(this, find_index(key, hash_of(key))); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	const_iterator find(const K& key) const {
+		return const_iterator(this, find_index(key, hash_of(key)));
+	}
+	bool contains(const Key& key) const {
+		return find_index(key, hash_of(key)) != slot_count();
+	}
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	bool contains(const K& key) const {
+		return find_index(key, hash_of(key)) != slot_count();
+	}
+
+	/* bucket interface */
+	// ведра - домашние слоты, запас за ними сюда не входит
+	size_type bucket_count() const { return mask + 1; }
+	size_type bucket_size(size_type n) const { return dist[n] != 0 ? 1 : 0; }
+
+	/* hash policy */
+	float load_factor() const { return static_cast<float>(size()) / bucket_count(); }
+	void rehash(size_type count) {
+		count = capacity_for(std::max<size_type>(count, std::ceil(size() / max_load_factor())));
+		if (count != bucket_count()) {
+			resize(count);
+		}
+	}
+	void reserve(size_type count) { rehash(std::ceil(count / max_load_factor())); }
+	void max_load_factor(float lf) {
+		max_saturation = std::clamp(lf, 0.125F, 0.95F);
+		if (size() > max_load_factor() * bucket_count()) {
+			reserve(size());
+		}
+	}
+	float max_load_factor() const { return max_saturation; }
+
+	/* observers */
+	Hash hash_function() const { return hash; }
+	KeyEqual key_eq() const { return equal; }
+
+	/* statistics */
+	// длина пробы - сколько слотов смотрит успешный поиск, 1 - элемент в своем доме. O(bucket_count)
+	size_type max_probe_length() const {
+		if (empty()) {
+			return 0;
+		}
+		return *std::max_element(dist.data(), dist.data() + dist.size());
+	}
+	double average_probe_length() const {
+		if (empty()) {
+			return 0;
+		}
+		size_type total = 0;
+		for (size_type i = 0; i < slot_count(); ++i) {
+			total += dist[i];
+		}
+		return static_cast<double>(total) / size();
+	}
+
+  private:
+	static size_type capacity_for(size_type count) {
+		return std::bit_ceil(std::max(count, INIT_CAPACITY));
+	}
+	// запас за последним ведром: дальше ни один элемент уйти не может
+	static size_type overflow_for(size_type capacity) {
+		return std::min(capacity, detail::ROBIN_HOOD_MAX_DISTANCE);
+	}
+	template <class K> std::size_t hash_of(const K& key) const { return detail::finalize_hash<Hash>(hash(key)); }
+	size_type slot_count() const { return slots.size(); }
+
+	void init_slots(size_type capacity) {
+		auto count = capacity + overflow_for(capacity);
+		slots = slots_type(count, alloc);
+		slots.resize(count);
+		dist = dist_type(count + 1, alloc);
+		dist.resize(count + 1);
+		std::fill_n(dist.data(), count + 1, std::uint8_t(0));
+		mask = capacity - 1;
+	}
+	void destroy_values() noexcept {
+		for (size_type i = 0; i < slot_count(); ++i) {
+			if (dist[i] != 0) {
+				std::destroy_at(&slots[i].value());
+			}
+		}
+	}
+
+	// с дистанцией d ключ был бы на месте, где живет элемент с дистанцией меньше d,
+	// поэтому дальше искать незачем. Нулевой слот в конце останавливает поиск
+	template <class K> size_type find_index(const K& key, std::size_t h) const {
+		if (slot_count() == 0) {
+			// после перемещения таблицы нет
+			return slot_count();
+		}
+		auto pos = h & mask;
+		for (size_type d = 1;; ++pos, ++d) {
+			if (dist[pos] < d) {
+				return slot_count();
+			}
+			if (dist[pos] == d && equal(slots[pos].value().first, key)) {
+				return pos;
+			}
+		}
+	}
+	// освобождает слот под новый элемент: хвост до ближайшего пустого слота сдвигается на шаг вперед.
+	// slot_count(), если сдвиг уперся в конец запаса или дистанция не помещается в байт
+	size_type prepare_slot(std::size_t h) {
+		auto pos = h & mask;
+		size_type d = 1;
+		for (; dist[pos] >= d; ++pos, ++d) {
+		}
+		auto free = pos;
+		for (; dist[free] != 0; ++free) {
+			if (dist[free] == detail::ROBIN_HOOD_MAX_DISTANCE) {
+				return slot_count();
+			}
+		}
+		if (free == slot_count() || d > detail::ROBIN_HOOD_MAX_DISTANCE) {
+			return slot_count();
+		}
+		for (auto i = free; i > pos; --i) {
+			std::construct_at(slots[i].raw(), std::move(slots[i - 1].value()));
+			std::destroy_at(&slots[i - 1].value());
+			dist[i] = dist[i - 1] + 1;
+		}
+		dist[pos] = static_cast<std::uint8_t>(d);
+		++items_count;
+		return pos;
+	}
+	template <class K> std::pair<size_type, bool> find_or_prepare(const K& key, std::size_t h) {
+		auto pos = find_index(key, h);
+		if (pos != slot_count()) {
+			return {pos, true};
+		}
+		if (slot_count() == 0) {
+			init_slots(INIT_CAPACITY);
+		}
+		if (size() + 1 > max_load_factor() * bucket_count()) {
+			resize(bucket_count() * 2);
+		}
+		while ((pos = prepare_slot(h)) == slot_count()) {
+			// длинный прогон в почти пустой таблице - признак плохого хеша, рост его не вылечит
+			if (size() < bucket_count() / 8) {
+				throw std::overflow_error("RobinHoodMap: probe distance overflow\n");
+			}
+			resize(bucket_count() * 2);
+		}
+		return {pos, false};
+	}
+	template <class K> size_type at_index(const K& key) const {
+		auto pos = find_index(key, hash_of(key));
+		if (pos == slot_count()) {
+			throw std::out_of_range("No value with key\n");
+		}
+		return pos;
+	}
+	template <class K, class... Args>
+	std::pair<iterator, bool> try_emplace_impl(K&& key, Args&&... args) {
+		auto [pos, found] = find_or_prepare(key, hash_of(key));
+		if (!found) {
+			construct_slot(pos, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+						   std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+		return {iterator(this, pos), !found};
+	}
+	template <class K, class M>
+	std::pair<iterator, bool> insert_or_assign_impl(K&& key, M&& obj) {
+		auto result = try_emplace_impl(std::forward<K>(key), std::forward<M>(obj));
+		if (!result.second) {
+			result.first->second = std::forward<M>(obj);
+		}
+		return result;
+	}
+	template <class K> size_type erase_impl(const K& key) {
+		auto pos = find_index(key, hash_of(key));
+		if (pos == slot_count()) {
+			return 0;
+		}
+		erase_slot(pos);
+		return 1;
+	}
+	// prepare_slot уже сдвинул хвост и занял pos: если конструктор бросит, сдвиг откатывается
+	template <class... Args> void construct_slot(size_type pos, Args&&... args) {
+		try {
+			std::construct_at(slots[pos].raw(), std::forward<Args>(args)...);
+		} catch (...) {
+			close_slot(pos);
+			throw;
+		}
+	}
+	void erase_slot(size_type pos) {
+		std::destroy_at(&slots[pos].value());
+		close_slot(pos);
+	}
+	// сдвиг назад: следующие элементы не в своем доме подтягиваются на шаг, надгробий нет.
+	// В pos живого значения уже нет. Это же в точности отменяет сдвиг из prepare_slot
+	void close_slot(size_type pos) {
+		for (; dist[pos + 1] > 1; ++pos) {
+			std::construct_at(slots[pos].raw(), std::move(slots[pos + 1].value()));
+			std::destroy_at(&slots[pos + 1].value());
+			dist[pos] = dist[pos + 1] - 1;
+		}
+		dist[pos] = 0;
+		--items_count;
+	}
+	void resize(size_type capacity) {
+		while (!try_resize(capacity)) {
+			capacity *= 2;
+		}
+	}
+	// новые слоты выделяются до того, как трогать старые, значения переносятся через
+	// move_if_noexcept: если выделение или перенос бросит, карта остается как была.
+	// false, если в новой таблице переполнился прогон: старая таблица возвращается на место
+	bool try_resize(size_type capacity) {
+		auto count = capacity + overflow_for(capacity);
+		slots_type new_slots(count, alloc);
+		new_slots.resize(count);
+		dist_type new_dist(count + 1, alloc);
+		new_dist.resize(count + 1);
+		std::fill_n(new_dist.data(), count + 1, std::uint8_t(0));
+		auto old_slots = std::exchange(slots, std::move(new_slots));
+		auto old_dist = std::exchange(dist, std::move(new_dist));
+		auto old_mask = std::exchange(mask, capacity - 1);
+		auto old_count = std::exchange(items_count, 0);
+		auto restore = [&] {
+			destroy_values();
+			slots = std::move(old_slots);
+			dist = std::move(old_dist);
+			mask = old_mask;
+			items_count = old_count;
+		};
+		try {
+			for (size_type i = 0; i < old_slots.size(); ++i) {
+				if (old_dist[i] != 0) {
+					auto& value = old_slots[i].value();
+					auto pos = prepare_slot(hash_of(value.first));
+					if (pos == slot_count()) {
+						restore();
+						return false;
+					}
+					construct_slot(pos, std::move_if_noexcept(value));
+				}
+			}
+		} catch (...) {
+			restore();
+			throw;
+		}
+		for (size_type i = 0; i < old_slots.size(); ++i) {
+			if (old_dist[i] != 0) {
+				std::destroy_at(&old_slots[i].value());
+			}
+		}
+		return true;
+	}
+};
+} // namespace tech
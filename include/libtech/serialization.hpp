@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define LIBTECH_HAS_FD_IO 1
+#endif
+
+namespace tech {
+// буферизованная запись в поток или файловый дескриптор: данные копируются в буфер
+// и уходят в приемник блоками по BUFFER_SIZE. Перед разрушением нужен flush()
+class BinaryWriter {
+  public:
+	static constexpr const std::size_t BUFFER_SIZE = 1 << 16;
+
+	explicit BinaryWriter(std::ostream& out) : stream(&out), buffer(std::make_unique<std::byte[]>(BUFFER_SIZE)) {}
+#if defined(LIBTECH_HAS_FD_IO)
+	// дескриптор не закрывается
+	explicit BinaryWriter(int fd) : descriptor(fd), buffer(std::make_unique<std::byte[]>(BUFFER_SIZE)) {}
+#endif
+
+	void write(const void* data, std::size_t bytes) {
+		if (bytes <= BUFFER_SIZE - used) {
+			std::memcpy(buffer.get() + used, data, bytes);
+			used += bytes;
+			return;
+		}
+		flush();
+		if (bytes >= BUFFER_SIZE) {
+			// большой кусок мимо буфера
+			sink(data, bytes);
+			return;
+		}
+		std::memcpy(buffer.get(), data, bytes);
+		used = bytes;
+	}
+	template <class T>
+		requires std::is_trivially_copyable_v<T>
+	void write_value(const T& value) {
+		write(&value, sizeof(T));
+	}
+	void flush() {
+		sink(buffer.get(), used);
+		used = 0;
+	}
+
+  private:
+	void sink(const void* data, std::size_t bytes) {
+		if (stream) {
+			stream->write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+			if (!*stream) {
+				throw std::runtime_error("BinaryWriter: stream write failed\n");
+			}
+			return;
+		}
+#if defined(LIBTECH_HAS_FD_IO)
+		auto* bytes_left = static_cast<const char*>(data);
+		while (bytes != 0) {
+			auto written = ::write(descriptor, bytes_left, bytes);
+			if (written < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				throw std::system_error(errno, std::generic_category(), "BinaryWriter: write");
+			}
+			bytes_left += written;
+			bytes -= static_cast<std::size_t>(written);
+		}
+#endif
+	}
+	std::ostream* stream = nullptr;
+	int descriptor = -1;
+	std::unique_ptr<std::byte[]> buffer;
+	std::size_t used = 0;
+};
+
+// буферизованное чтение, конец данных посреди значения - исключение
+class BinaryReader {
+  public:
+	static constexpr const std::size_t BUFFER_SIZE = 1 << 16;
+
+	explicit BinaryReader(std::istream& in) : stream(&in), buffer(std::make_unique<std::byte[]>(BUFFER_SIZE)) {}
+#if defined(LIBTECH_HAS_FD_IO)
+	explicit BinaryReader(int fd) : descriptor(fd), buffer(std::make_unique<std::byte[]>(BUFFER_SIZE)) {}
+#endif
+
+	void read(void* data, std::size_t bytes) {
+		auto* out = static_cast<std::byte*>(data);
+		while (bytes != 0) {
+			if (position == filled) {
+				if (bytes >= BUFFER_SIZE) {
+					// большой кусок мимо буфера
+					source_exact(out, bytes);
+					return;
+				}
+				position = 0;
+				filled = source(buffer.get(), BUFFER_SIZE);
+				if (filled == 0) {
+					throw std::runtime_error("BinaryReader: unexpected end of data\n");
+				}
+			}
+			auto chunk = std::min(bytes, filled - position);
+			std::memcpy(out, buffer.get() + position, chunk);
+			position += chunk;
+			out += chunk;
+			bytes -= chunk;
+		}
+	}
+	// вернуть источнику прочитанное наперед, чтобы за данными карты из него можно было читать дальше.
+	// Нужен поток или дескриптор с позиционированием
+	void rewind_unread() {
+		auto unread = static_cast<std::streamoff>(filled - position);
+		position = filled = 0;
+		if (unread == 0) {
+			return;
+		}
+		if (stream) {
+			stream->clear();
+			if (!stream->seekg(-unread, std::ios::cur)) {
+				throw std::runtime_error("BinaryReader: stream is not seekable\n");
+			}
+			return;
+		}
+#if defined(LIBTECH_HAS_FD_IO)
+		if (::lseek(descriptor, -static_cast<off_t>(unread), SEEK_CUR) < 0) {
+			throw std::system_error(errno, std::generic_category(), "BinaryReader: lseek");
+		}
+#endif
+	}
+	template <class T>
+		requires std::is_trivially_copyable_v<T>
+	T read_value() {
+		std::array<std::byte, sizeof(T)> raw;
+		read(raw.data(), sizeof(T));
+		return std::bit_cast<T>(raw);
+	}
+
+  private:
+	// сколько удалось прочитать, 0 - конец данных
+	std::size_t source(std::byte* data, std::size_t bytes) {
+		if (stream) {
+			stream->read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(bytes));
+			return static_cast<std::size_t>(stream->gcount());
+		}
+#if defined(LIBTECH_HAS_FD_IO)
+		while (true) {
+			auto got = ::read(descriptor, data, bytes);
+			if (got >= 0) {
+				return static_cast<std::size_t>(got);
+			}
+			if (errno != EINTR) {
+				throw std::system_error(errno, std::generic_category(), "BinaryReader: read");
+			}
+		}
+#else
+		return 0;
+#endif
+	}
+	void source_exact(std::byte* data, std::size_t bytes) {
+		while (bytes != 0) {
+			auto got = source(data, bytes);
+			if (got == 0) {
+				throw std::runtime_error("BinaryReader: unexpected end of data\n");
+			}
+			data += got;
+			bytes -= got;
+		}
+	}
+	std::istream* stream = nullptr;
+	int descriptor = -1;
+	std::unique_ptr<std::byte[]> buffer;
+	std::size_t position = 0;
+	std::size_t filled = 0;
+};
+
+// точка расширения: как писать и читать ключи и значения. Для своего типа
+// специализируется serializer<T> со static write(BinaryWriter&, const T&) и T read(BinaryReader&).
+// Тривиально копируемые типы пишутся байтами, std::string - длиной и содержимым
+template <class T, class = void> struct serializer;
+template <class T> struct serializer<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+	static void write(BinaryWriter& writer, const T& value) { writer.write_value(value); }
+	static T read(BinaryReader& reader) { return reader.read_value<T>(); }
+};
+template <class CharT, class Traits, class Allocator> struct serializer<std::basic_string<CharT, Traits, Allocator>> {
+	using string_type = std::basic_string<CharT, Traits, Allocator>;
+	static void write(BinaryWriter& writer, const string_type& value) {
+		writer.write_value(static_cast<std::uint64_t>(value.size()));
+		writer.write(value.data(), value.size() * sizeof(CharT));
+	}
+	static string_type read(BinaryReader& reader) {
+		auto size = reader.read_value<std::uint64_t>();
+		string_type value(static_cast<std::size_t>(size), CharT());
+		reader.read(value.data(), value.size() * sizeof(CharT));
+		return value;
+	}
+};
+
+namespace detail {
+// заголовок сохраненной карты, дальше блоки {число элементов, элементы}, пустой блок - конец
+struct SerializedHeader {
+	static constexpr const char MAGIC[8] = {'T', 'E', 'C', 'H', 'H', 'M', 'A', 'P'};
+	static constexpr const std::uint32_t VERSION = 1;
+	static constexpr const std::uint32_t ENDIAN_MARK = 0x01020304;
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t endian_mark;
+	std::uint64_t bucket_count;
+	std::uint64_t size;
+
+	static SerializedHeader make(std::uint64_t buckets, std::uint64_t items) {
+		SerializedHeader header{};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.endian_mark = ENDIAN_MARK;
+		header.bucket_count = buckets;
+		header.size = items;
+		return header;
+	}
+	void check() const {
+		if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+			throw std::runtime_error("HashMap::load: bad magic\n");
+		}
+		if (version != VERSION || endian_mark != ENDIAN_MARK) {
+			throw std::runtime_error("HashMap::load: unsupported version or byte order\n");
+		}
+	}
+};
+inline constexpr const std::uint64_t SERIALIZED_BLOCK_ITEMS = 4096;
+} // namespace detail
+} // namespace tech
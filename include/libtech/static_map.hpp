@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <libtech/hash.hpp>
+#include <libtech/hash_traits.hpp>
+#include <stdexcept>
+#include <utility>
+
+namespace tech {
+namespace detail {
+// старшие 64 бита произведения: x равномерно отображается в [0, n) без деления
+constexpr std::uint64_t mul_high(std::uint64_t x, std::uint64_t n) noexcept {
+#if defined(__SIZEOF_INT128__)
+	__extension__ using wide = unsigned __int128;
+	return static_cast<std::uint64_t>((static_cast<wide>(x) * n) >> 64);
+#else
+	std::uint64_t x_lo = x & 0xFFFFFFFF, x_hi = x >> 32, n_lo = n & 0xFFFFFFFF, n_hi = n >> 32;
+	std::uint64_t lo_lo = x_lo * n_lo, hi_lo = x_hi * n_lo, lo_hi = x_lo * n_hi, hi_hi = x_hi * n_hi;
+	std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+	return hi_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+}
+
+// в среднем два ключа на группу: 2 байта пилотов на ключ и короткий подбор при сборке
+constexpr std::size_t static_map_buckets(std::size_t items) noexcept { return items / 2 + 1; }
+inline constexpr const std::uint32_t STATIC_MAP_MAX_PILOT = 1 << 24;
+} // namespace detail
+
+// неизменяемая карта с минимальным совершенным хешем (PTHash): ключи разложены по группам,
+// для каждой группы подобран пилот, при котором ее ключи попадают в свободные ячейки.
+// Ячеек ровно N, поиск - один пилот, одна ячейка и одно сравнение ключа.
+// Собирается make_static_map, в constexpr переменной - во время компиляции
+template <class Key, class T, std::size_t N, class Hash = tech::Hash<Key>, class KeyEqual = std::equal_to<Key>>
+class StaticMap {
+  public:
+	using key_type = Key;
+	using mapped_type = T;
+	using value_type = std::pair<Key, T>;
+	using size_type = std::size_t;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using const_iterator = const value_type*;
+	using iterator = const_iterator;
+
+	static constexpr const size_type BUCKETS = detail::static_map_buckets(N);
+
+	constexpr explicit StaticMap(const std::array<value_type, N>& items, const Hash& hash = Hash(),
+								 const KeyEqual& equal = KeyEqual())
+		: hash(hash), equal(equal) {
+		build(items);
+	}
+
+	/* lookup */
+
+	constexpr const_iterator find(const Key& key) const { return find_impl(key); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	constexpr const_iterator find(const K& key) const { return find_impl(key); }
+	constexpr bool contains(const Key& key) const { return find_impl(key) != end(); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	constexpr bool contains(const K& key) const { return find_impl(key) != end(); }
+	constexpr size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	constexpr size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+	constexpr const T& at(const Key& key) const { return at_impl(key); }
+	template <class K> requires transparent_lookup<Hash, KeyEqual>
+	constexpr const T& at(const K& key) const { return at_impl(key); }
+
+	/* iterators */
+
+	constexpr const_iterator begin() const noexcept { return slots.data(); }
+	constexpr const_iterator end() const noexcept { return slots.data() + N; }
+	constexpr const_iterator cbegin() const noexcept { return begin(); }
+	constexpr const_iterator cend() const noexcept { return end(); }
+
+	/* capacity */
+
+	constexpr bool empty() const noexcept { return N == 0; }
+	constexpr size_type size() const noexcept { return N; }
+	constexpr size_type max_size() const noexcept { return N; }
+
+	/* observers */
+
+	constexpr hasher hash_function() const { return hash; }
+	constexpr key_equal key_eq() const { return equal; }
+
+  private:
+	template <class K> constexpr std::uint64_t hash_of(const K& key) const {
+		return static_cast<std::uint64_t>(detail::finalize_hash<Hash>(hash(key)));
+	}
+	static constexpr size_type bucket_of(std::uint64_t h) noexcept {
+		return static_cast<size_type>(detail::mul_high(h, BUCKETS));
+	}
+	static constexpr size_type slot_of(std::uint64_t h, std::uint32_t pilot) noexcept {
+		return static_cast<size_type>(detail::mul_high(detail::mix64(h ^ (pilot * detail::SECRET[2])), N));
+	}
+	template <class K> constexpr const_iterator find_impl(const K& key) const {
+		if constexpr (N == 0) {
+			return end();
+		} else {
+			auto h = hash_of(key);
+			auto slot = slot_of(h, pilots[bucket_of(h)]);
+			// ключ в таблице или на своей ячейке, или его нет
+			return equal(slots[slot].first, key) ? slots.data() + slot : end();
+		}
+	}
+	template <class K> constexpr const T& at_impl(const K& key) const {
+		auto it = find_impl(key);
+		if (it == end()) {
+			throw std::out_of_range("StaticMap::at: key not found\n");
+		}
+		return it->second;
+	}
+
+	constexpr void build(const std::array<value_type, N>& items) {
+		if constexpr (N != 0) {
+			std::array<std::uint64_t, N> hashes{};
+			std::array<size_type, N> order{};
+			for (size_type i = 0; i < N; ++i) {
+				hashes[i] = hash_of(items[i].first);
+				order[i] = i;
+			}
+			// одинаковый хеш не развести никаким пилотом: это либо повтор ключа, либо коллизия 64 бит
+			std::sort(order.begin(), order.end(), [&](size_type a, size_type b) { return hashes[a] < hashes[b]; });
+			for (size_type i = 1; i < N; ++i) {
+				if (hashes[order[i]] == hashes[order[i - 1]]) {
+					if (equal(items[order[i]].first, items[order[i - 1]].first)) {
+						throw std::invalid_argument("make_static_map: duplicate key\n");
+					}
+					throw std::invalid_argument("make_static_map: 64-bit hash collision\n");
+				}
+			}
+
+			// ключи по группам подсчетом: members[starts[b], starts[b + 1]) - ключи группы b
+			std::array<size_type, BUCKETS + 1> starts{};
+			for (size_type i = 0; i < N; ++i) {
+				++starts[bucket_of(hashes[i]) + 1];
+			}
+			for (size_type b = 0; b < BUCKETS; ++b) {
+				starts[b + 1] += starts[b];
+			}
+			std::array<size_type, N> members{};
+			std::array<size_type, BUCKETS> filled{};
+			for (size_type i = 0; i < N; ++i) {
+				auto b = bucket_of(hashes[i]);
+				members[starts[b] + filled[b]++] = i;
+			}
+
+			// большие группы первыми, пока свободных ячеек много
+			std::array<size_type, BUCKETS> buckets{};
+			for (size_type b = 0; b < BUCKETS; ++b) {
+				buckets[b] = b;
+			}
+			std::sort(buckets.begin(), buckets.end(), [&](size_type a, size_type b) {
+				auto a_size = starts[a + 1] - starts[a];
+				auto b_size = starts[b + 1] - starts[b];
+				return a_size != b_size ? a_size > b_size : a < b;
+			});
+
+			std::array<bool, N> taken{};
+			std::array<size_type, N> slot_of_item{};
+			for (auto b : buckets) {
+				auto first = starts[b];
+				auto last = starts[b + 1];
+				if (first == last) {
+					break;
+				}
+				std::uint32_t pilot = 0;
+				while (!try_pilot(hashes, members, first, last, pilot, taken, slot_of_item)) {
+					if (++pilot == detail::STATIC_MAP_MAX_PILOT) {
+						throw std::runtime_error("make_static_map: pilot search failed\n");
+					}
+				}
+				pilots[b] = pilot;
+			}
+			for (size_type i = 0; i < N; ++i) {
+				slots[slot_of_item[i]] = items[i];
+			}
+		}
+	}
+	// все ключи группы в свободные и разные ячейки; при успехе ячейки занимаются
+	static constexpr bool try_pilot(const std::array<std::uint64_t, N>& hashes, const std::array<size_type, N>& members,
+									size_type first, size_type last, std::uint32_t pilot, std::array<bool, N>& taken,
+									std::array<size_type, N>& slot_of_item) {
+		for (auto i = first; i < last; ++i) {
+			auto slot = slot_of(hashes[members[i]], pilot);
+			if (taken[slot]) {
+				return false;
+			}
+			for (auto j = first; j < i; ++j) {
+				if (slot_of_item[members[j]] == slot) {
+					return false;
+				}
+			}
+			slot_of_item[members[i]] = slot;
+		}
+		for (auto i = first; i < last; ++i) {
+			taken[slot_of_item[members[i]]] = true;
+		}
+		return true;
+	}
+
+	std::array<value_type, N> slots{};
+	std::array<std::uint32_t, BUCKETS> pilots{};
+	[[no_unique_address]] Hash hash;
+	[[no_unique_address]] KeyEqual equal;
+};
+
+// constexpr auto methods = tech::make_static_map<std::string_view, int>({{"GET", 1}, {"POST", 2}});
+// Повтор ключа - исключение, в constexpr контексте - ошибка компиляции
+template <class Key, class T, class Hash = tech::Hash<Key>, class KeyEqual = std::equal_to<Key>, std::size_t N>
+constexpr StaticMap<Key, T, N, Hash, KeyEqual> make_static_map(const std::pair<Key, T> (&items)[N]) {
+	std::array<std::pair<Key, T>, N> copy{};
+	std::copy(items, items + N, copy.begin());
+	return StaticMap<Key, T, N, Hash, KeyEqual>(copy);
+}
+template <class Key, class T, class Hash = tech::Hash<Key>, class KeyEqual = std::equal_to<Key>, std::size_t N>
+constexpr StaticMap<Key, T, N, Hash, KeyEqual> make_static_map(const std::array<std::pair<Key, T>, N>& items) {
+	return StaticMap<Key, T, N, Hash, KeyEqual>(items);
+}
+} // namespace tech
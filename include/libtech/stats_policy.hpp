@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace tech {
+// снимок статистики карты: счетчики политики и форма таблицы на момент вызова stats()
+struct HashMapStats {
+	static constexpr const std::size_t CHAIN_HISTOGRAM_SIZE = 16;
+
+	std::uint64_t lookups = 0;
+	std::uint64_t hits = 0;
+	std::uint64_t misses = 0;
+	std::uint64_t rehashes = 0;
+	std::chrono::nanoseconds rehash_time{0};
+	std::uint64_t allocations = 0;
+	std::uint64_t allocated_bytes = 0;
+
+	std::size_t size = 0;
+	std::size_t bucket_count = 0;
+	float load_factor = 0;
+	float max_load_factor = 0;
+	std::size_t max_chain = 0;
+	// chain_lengths[k] - число ведер из k элементов, последний - из CHAIN_HISTOGRAM_SIZE - 1 и больше
+	std::array<std::size_t, CHAIN_HISTOGRAM_SIZE> chain_lengths{};
+};
+
+// строка на метрику "имя значение", чтобы разбирать построчно
+inline void dump_stats(std::ostream& out, const HashMapStats& stats) {
+	out << "lookups " << stats.lookups << '\n'
+		<< "hits " << stats.hits << '\n'
+		<< "misses " << stats.misses << '\n'
+		<< "rehashes " << stats.rehashes << '\n'
+		<< "rehash_time_ns " << stats.rehash_time.count() << '\n'
+		<< "allocations " << stats.allocations << '\n'
+		<< "allocated_bytes " << stats.allocated_bytes << '\n'
+		<< "size " << stats.size << '\n'
+		<< "bucket_count " << stats.bucket_count << '\n'
+		<< "load_factor " << stats.load_factor << '\n'
+		<< "max_load_factor " << stats.max_load_factor << '\n'
+		<< "max_chain " << stats.max_chain << '\n';
+	for (std::size_t k = 0; k < HashMapStats::CHAIN_HISTOGRAM_SIZE; ++k) {
+		out << "chain_length_" << k << (k + 1 == HashMapStats::CHAIN_HISTOGRAM_SIZE ? "_or_more " : " ")
+			<< stats.chain_lengths[k] << '\n';
+	}
+}
+
+/* stats policies
+ * enabled - считает ли политика что-нибудь
+ * on_lookup(hit) - любой поиск ключа: find/contains/at/count, пакетный, а также внутри вставок, erase, extract и merge
+ * on_allocate(bytes) - выделение нод, массива ведер, битмапа непустых ведер и массива хешей bulk_insert
+ * timed_rehash(f) - вызывает f, учитывая rehash и его время
+ * add(other) - добавить счетчики другой карты той же политики
+ * fill(stats) - записать счетчики в снимок
+ */
+
+// по умолчанию: пустые функции, [[no_unique_address]] в карте - ни байта, ни инструкции
+struct NoStatsPolicy {
+	static constexpr const bool enabled = false;
+	void on_lookup(bool /*hit*/) const noexcept {}
+	void on_allocate(std::size_t /*bytes*/) const noexcept {}
+	template <class F> void timed_rehash(F&& f) const { f(); }
+	void add(const NoStatsPolicy& /*other*/) const noexcept {}
+	void fill(HashMapStats& /*stats*/) const noexcept {}
+};
+
+// счетчики relaxed атомарные: поиск в const методах из нескольких потоков не гонка.
+// Копия и перемещенная карта считают с нуля
+class CountingStatsPolicy {
+  public:
+	static constexpr const bool enabled = true;
+
+	CountingStatsPolicy() = default;
+	CountingStatsPolicy(const CountingStatsPolicy& /*other*/) noexcept {}
+	CountingStatsPolicy& operator=(const CountingStatsPolicy& /*other*/) noexcept { return *this; }
+
+	void on_lookup(bool hit) const noexcept {
+		lookups.fetch_add(1, std::memory_order_relaxed);
+		(hit ? hits : misses).fetch_add(1, std::memory_order_relaxed);
+	}
+	void on_allocate(std::size_t bytes) const noexcept {
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+	}
+	template <class F> void timed_rehash(F&& f) const {
+		auto start = std::chrono::steady_clock::now();
+		f();
+		auto spent = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		rehashes.fetch_add(1, std::memory_order_relaxed);
+		rehash_ns.fetch_add(static_cast<std::uint64_t>(spent.count()), std::memory_order_relaxed);
+	}
+	void add(const CountingStatsPolicy& other) const noexcept {
+		lookups.fetch_add(other.lookups.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		hits.fetch_add(other.hits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		misses.fetch_add(other.misses.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		rehashes.fetch_add(other.rehashes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		rehash_ns.fetch_add(other.rehash_ns.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		allocations.fetch_add(other.allocations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		allocated_bytes.fetch_add(other.allocated_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+	void fill(HashMapStats& stats) const noexcept {
+		stats.lookups = lookups.load(std::memory_order_relaxed);
+		stats.hits = hits.load(std::memory_order_relaxed);
+		stats.misses = misses.load(std::memory_order_relaxed);
+		stats.rehashes = rehashes.load(std::memory_order_relaxed);
+		stats.rehash_time = std::chrono::nanoseconds(rehash_ns.load(std::memory_order_relaxed));
+		stats.allocations = allocations.load(std::memory_order_relaxed);
+		stats.allocated_bytes = allocated_bytes.load(std::memory_order_relaxed);
+	}
+
+  private:
+	mutable std::atomic<std::uint64_t> lookups{0};
+	mutable std::atomic<std::uint64_t> hits{0};
+	mutable std::atomic<std::uint64_t> misses{0};
+	mutable std::atomic<std::uint64_t> rehashes{0};
+	mutable std::atomic<std::uint64_t> rehash_ns{0};
+	mutable std::atomic<std::uint64_t> allocations{0};
+	mutable std::atomic<std::uint64_t> allocated_bytes{0};
+};
+} // namespace tech
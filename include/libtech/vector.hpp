@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <initializer_list>
 #include <memory>
+#include <stdexcept>
 
 namespace tech {
 template <class T, class Allocator = std::allocator<T>> class Vector {
@@ -14,53 +16,90 @@ template <class T, class Allocator = std::allocator<T>> class Vector {
 	using reference = value_type&;
 	using const_reference = const value_type&;
 	using pointer = T*;
+	using allocator_type = Allocator;
 
   private:
+	using alloc_traits = std::allocator_traits<Allocator>;
 	T* _items;
 	size_type _count;
 	size_type _capacity;
+	[[no_unique_address]] Allocator alloc;
 	constexpr void clean() {
 		std::destroy_n(_items, _count);
 		_count = 0;
-		Allocator().deallocate(_items, _capacity);
+		if (_items != nullptr) {
+			alloc_traits::deallocate(alloc, _items, _capacity);
+		}
+	}
+	constexpr void steal(Vector& other) noexcept {
+		_items = other._items;
+		_count = other._count;
+		_capacity = other._capacity;
+		other._items = nullptr;
+		other._count = 0;
+		other._capacity = 0;
 	}
 
   public:
 	/* constructors */
-	constexpr Vector() noexcept(noexcept(Allocator()))
-		: _items(nullptr), _count(0), _capacity(0) {}
-	constexpr Vector(size_type count)
-		: _items(Allocator().allocate(count)), _count(0), _capacity(count) {}
-	constexpr Vector(std::initializer_list<T> init) {}
+	constexpr Vector() noexcept(noexcept(Allocator())) : Vector(Allocator()) {}
+	constexpr explicit Vector(const Allocator& allocator) noexcept
+		: _items(nullptr), _count(0), _capacity(0), alloc(allocator) {}
+	constexpr Vector(size_type count, const Allocator& allocator = Allocator())
+		: _items(nullptr), _count(0), _capacity(count), alloc(allocator) {
+		_items = alloc_traits::allocate(alloc, count);
+	}
+	constexpr Vector(std::initializer_list<T> init, const Allocator& allocator = Allocator())
+		: Vector(init.size(), allocator) {
+		std::uninitialized_copy_n(init.begin(), init.size(), _items);
+		_count = init.size();
+	}
 
 	/* rule of 5 */
-	constexpr Vector(const Vector& other) noexcept
-		: _items(Allocator().allocate(other.capacity())), _count(other.size()),
-		  _capacity(other.capacity()) {
+	constexpr Vector(const Vector& other)
+		: Vector(other.capacity(), alloc_traits::select_on_container_copy_construction(other.alloc)) {
 		std::uninitialized_copy_n(other.data(), other.size(), _items);
+		_count = other.size();
 	}
 	constexpr Vector(Vector&& other) noexcept
-		: _items(other.data()), _count(other.size()),
-		  _capacity(other.capacity()) {
-		other._items = nullptr;
-		other._count = 0;
-		other._capacity = 0;
+		: _items(nullptr), _count(0), _capacity(0), alloc(std::move(other.alloc)) {
+		steal(other);
 	}
 	constexpr Vector& operator=(const Vector& other) {
+		if (this == &other) {
+			return *this;
+		}
 		clean();
-		_items = Allocator().allocate(other.capacity());
+		_items = nullptr;
+		_capacity = 0;
+		if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+			alloc = other.alloc;
+		}
+		_items = alloc_traits::allocate(alloc, other.capacity());
 		_capacity = other.capacity();
-		_count = other.size();
 		std::uninitialized_copy_n(other.data(), other.size(), _items);
+		_count = other.size();
+		return *this;
 	}
 	constexpr Vector& operator=(Vector&& other) {
+		if (this == &other) {
+			return *this;
+		}
 		clean();
-		_items = other.data();
-		_count = other.size();
-		_capacity = other.capacity();
-		other._items = nullptr;
-		other._count = 0;
-		other._capacity = 0;
+		_items = nullptr;
+		_capacity = 0;
+		if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+			alloc = std::move(other.alloc);
+		} else if (alloc != other.alloc) {
+			// чужой аллокатор нельзя забрать, переносим элементы поштучно
+			_items = alloc_traits::allocate(alloc, other.size());
+			_capacity = other.size();
+			std::uninitialized_move_n(other.data(), other.size(), _items);
+			_count = other.size();
+			other.clear();
+			return *this;
+		}
+		steal(other);
 		return *this;
 	}
 	constexpr ~Vector() { clean(); }
@@ -73,9 +112,14 @@ template <class T, class Allocator = std::allocator<T>> class Vector {
 		return _items[pos];
 	}
 	constexpr reference operator[](size_type pos) { return _items[pos]; }
+	constexpr const_reference operator[](size_type pos) const {
+		return _items[pos];
+	}
 	constexpr reference front() { return _items[0]; }
 	constexpr reference back() { return _items[_count - 1]; }
 	constexpr pointer data() { return _items; }
+	constexpr const T* data() const { return _items; }
+	constexpr allocator_type get_allocator() const noexcept { return alloc; }
 
 	template <class ValueType> class Iterator {
 	  private:
@@ -153,7 +197,7 @@ template <class T, class Allocator = std::allocator<T>> class Vector {
 		if (new_cap <= capacity()) {
 			return;
 		}
-		value_type* new_items = Allocator().allocate(new_cap);
+		value_type* new_items = alloc_traits::allocate(alloc, new_cap);
 		if (_items != nullptr) { // если у нас что то было
 			std::uninitialized_move_n(_items, size(), new_items);
 			auto old_count = _count;
@@ -183,13 +227,13 @@ template <class T, class Allocator = std::allocator<T>> class Vector {
 		if (_count == _capacity) {
 			auto new_capacity = _capacity * 2;
 			auto new_count = _count + 1;
-			value_type* new_items = Allocator().allocate(_capacity * 2);
+			value_type* new_items = alloc_traits::allocate(alloc, new_capacity);
 			std::construct_at(new_items + _count, std::forward<Args>(args)...);
 			for (size_type i = 0; i < _count; ++i) {
 				std::uninitialized_move_n(_items + i, 1, new_items + i);
 				std::destroy_at(_items + i);
 			}
-			Allocator().deallocate(_items, _capacity);
+			alloc_traits::deallocate(alloc, _items, _capacity);
 			// std::uninitialized_move_n(_items, size(), new_items); надо
 			// поэлементно перемещать clean();
 			_items = new_items;
@@ -211,6 +255,7 @@ template <class T, class Allocator = std::allocator<T>> class Vector {
 		}
 		if (new_count < size()) {
 			std::destroy(Iterator<value_type>(_items + new_count), end());
+			_count = new_count;
 		} else {
 			if (new_count > capacity()) {
 				reserve(new_count);
@@ -0,0 +1,292 @@
+#include <gtest/gtest.h>
+#include <libtech/allocator.hpp>
+#include <libtech/flat_hashmap.hpp>
+#include <libtech/hash_multimap.hpp>
+#include <libtech/hashmap.hpp>
+#include <libtech/list.hpp>
+#include <libtech/robin_hood_map.hpp>
+#include <libtech/vector.hpp>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using PoolMap = tech::HashMap<int, std::string, std::hash<int>, std::equal_to<int>, tech::PoolAllocator<std::pair<int, std::string>>>;
+using ArenaMap = tech::HashMap<int, int, std::hash<int>, std::equal_to<int>, tech::ArenaAllocator<std::pair<int, int>>>;
+
+TEST(AllocatorTest, PoolHashMapTest) {
+	PoolMap my_map;
+	for (int i = 0; i < 1000; ++i) {
+		my_map[i] = std::to_string(i);
+	}
+	for (int i = 0; i < 1000; i += 2) {
+		my_map.erase(my_map.find(i));
+	}
+	ASSERT_EQ(my_map.size(), 500);
+	ASSERT_EQ(my_map.at(501), "501");
+	PoolMap copy = my_map;
+	ASSERT_EQ(copy.get_allocator(), my_map.get_allocator());
+	ASSERT_EQ(copy.at(999), "999");
+	PoolMap other;
+	other = std::move(copy);
+	ASSERT_EQ(other.get_allocator(), my_map.get_allocator());
+	ASSERT_EQ(other.size(), 500);
+	// moved-from карта по-прежнему выделяет ноды из того же пула
+	ASSERT_EQ(copy.get_allocator(), my_map.get_allocator());
+	copy[1] = "1";
+	ASSERT_EQ(copy.size(), 1);
+}
+
+TEST(AllocatorTest, ArenaHashMapTest) {
+	tech::Arena arena;
+	{
+		ArenaMap my_map{tech::ArenaAllocator<std::pair<int, int>>(arena)};
+		for (int i = 0; i < 1000; ++i) {
+			my_map.emplace(i, i * i);
+		}
+		ASSERT_EQ(my_map.at(30), 900);
+		ASSERT_EQ(my_map.get_allocator().resource(), &arena);
+	}
+	ASSERT_GT(arena.bytes_allocated(), 1000 * sizeof(std::pair<int, int>));
+	arena.release();
+	ASSERT_EQ(arena.bytes_allocated(), 0);
+	// bulk_insert берет из арены только ноды, массив хешей временный
+	ArenaMap bulk(127, {}, {}, tech::ArenaAllocator<std::pair<int, int>>(arena));
+	std::vector<std::pair<int, int>> values;
+	for (int i = 0; i < 100; ++i) {
+		values.emplace_back(i, i);
+	}
+	auto before = arena.bytes_allocated();
+	ASSERT_EQ(bulk.bulk_insert(values.begin(), values.end()), 100);
+	ASSERT_EQ(bulk.bucket_count(), 127);
+	ASSERT_EQ(arena.bytes_allocated() - before, 100 * sizeof(ArenaMap::node_type));
+}
+
+TEST(AllocatorTest, ArenaPropagationTest) {
+	tech::Arena first_arena;
+	tech::Arena second_arena;
+	tech::ArenaAllocator<int> first(first_arena);
+	tech::ArenaAllocator<int> second(second_arena);
+	tech::Vector<int, tech::ArenaAllocator<int>> a(first);
+	tech::Vector<int, tech::ArenaAllocator<int>> b(second);
+	for (int i = 0; i < 10; ++i) {
+		a.push_back(i);
+	}
+	b = a; // copy assignment does not propagate the arena
+	ASSERT_EQ(b.get_allocator(), second);
+	ASSERT_EQ(b.size(), 10);
+	ASSERT_EQ(b[9], 9);
+	ArenaMap first_map{tech::ArenaAllocator<std::pair<int, int>>(first_arena)};
+	ArenaMap second_map{tech::ArenaAllocator<std::pair<int, int>>(second_arena)};
+	first_map[1] = 2;
+	second_map = first_map;
+	ASSERT_EQ(second_map.get_allocator().resource(), &second_arena);
+	ASSERT_EQ(second_map.at(1), 2);
+	second_map = std::move(first_map); // move assignment does
+	ASSERT_EQ(second_map.get_allocator().resource(), &first_arena);
+	// новые ведра и битмап непустых ведер тоже из первой арены
+	ArenaMap third_map{tech::ArenaAllocator<std::pair<int, int>>(second_arena)};
+	third_map[3] = 4;
+	auto second_used = second_arena.bytes_allocated();
+	second_map.rehash(1000);
+	second_map = third_map;
+	ASSERT_EQ(second_arena.bytes_allocated(), second_used);
+	ASSERT_EQ(second_map.at(3), 4);
+}
+
+TEST(AllocatorTest, PoolListTest) {
+	tech::List<std::string, tech::PoolAllocator<std::string>> my_list;
+	for (int i = 0; i < 100; ++i) {
+		my_list.push_back(std::to_string(i));
+	}
+	my_list.erase(my_list.begin());
+	ASSERT_EQ(my_list.size(), 99);
+	ASSERT_EQ(my_list.front(), "1");
+	auto copy = my_list;
+	ASSERT_EQ(copy.get_allocator(), my_list.get_allocator());
+	ASSERT_EQ(copy.back(), "99");
+}
+
+TEST(AllocatorTest, PoolFlatHashMapTest) {
+	tech::FlatHashMap<int, int, std::hash<int>, std::equal_to<int>, tech::PoolAllocator<std::pair<int, int>>> my_map;
+	for (int i = 0; i < 1000; ++i) {
+		my_map[i] = -i;
+	}
+	auto copy = my_map;
+	ASSERT_EQ(copy.size(), 1000);
+	ASSERT_EQ(copy.at(500), -500);
+}
+
+struct alignas(64) WideValue {
+	int value = 0;
+};
+
+TEST(AllocatorTest, PoolOverAlignedTest) {
+	tech::HashMap<int, WideValue, std::hash<int>, std::equal_to<int>, tech::PoolAllocator<std::pair<int, WideValue>>> my_map;
+	for (int i = 0; i < 100; ++i) {
+		my_map[i].value = i;
+	}
+	for (const auto& [key, value] : my_map) {
+		ASSERT_EQ(reinterpret_cast<std::uintptr_t>(&value) % alignof(WideValue), 0);
+		ASSERT_EQ(value.value, key);
+	}
+	for (int i = 0; i < 100; i += 2) {
+		my_map.erase(my_map.find(i));
+	}
+	ASSERT_EQ(my_map.size(), 50);
+	// сверхвыровненные запросы идут мимо пула и не занимают классы размера
+	tech::PoolResource pool;
+	std::vector<void*> wide;
+	for (std::size_t i = 1; i <= tech::PoolResource::MAX_SIZE_CLASSES; ++i) {
+		wide.push_back(pool.allocate(i * 64, 64));
+	}
+	ASSERT_EQ(pool.size_class_count(), 0);
+	auto* small = pool.allocate(sizeof(int), alignof(int));
+	ASSERT_EQ(pool.size_class_count(), 1);
+	pool.deallocate(small, sizeof(int), alignof(int));
+	for (std::size_t i = 0; i < wide.size(); ++i) {
+		pool.deallocate(wide[i], (i + 1) * 64, 64);
+	}
+	ASSERT_EQ(pool.size_class_count(), 1);
+}
+
+// бросает bad_alloc, когда общий на все копии бюджет выделений исчерпан
+template <class T> class BudgetAllocator {
+  public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	explicit BudgetAllocator(std::shared_ptr<std::size_t> allocations_left) noexcept : budget(std::move(allocations_left)) {}
+	template <class U> BudgetAllocator(const BudgetAllocator<U>& other) noexcept : budget(other.resource()) {}
+
+	T* allocate(std::size_t n) {
+		if (*budget == 0) {
+			throw std::bad_alloc();
+		}
+		--*budget;
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T* ptr, std::size_t n) noexcept { std::allocator<T>().deallocate(ptr, n); }
+	const std::shared_ptr<std::size_t>& resource() const noexcept { return budget; }
+	template <class U> bool operator==(const BudgetAllocator<U>& other) const noexcept {
+		return budget == other.resource();
+	}
+
+  private:
+	std::shared_ptr<std::size_t> budget;
+};
+
+TEST(AllocatorTest, ThrowingRehashTest) {
+	auto budget = std::make_shared<std::size_t>(SIZE_MAX);
+	using Alloc = BudgetAllocator<std::pair<int, int>>;
+	tech::HashMap<int, int, std::hash<int>, std::equal_to<int>, Alloc> my_map{Alloc(budget)};
+	for (int i = 0; i < 100; ++i) {
+		my_map[i] = i;
+	}
+	auto buckets_count = my_map.bucket_count();
+	*budget = 0;
+	ASSERT_THROW(my_map.rehash(buckets_count * 10), std::bad_alloc);
+	// рост внутри вставки тоже бросает, уже созданная нода не теряется
+	*budget = 1;
+	my_map.max_load_factor(my_map.load_factor());
+	ASSERT_THROW(my_map.emplace(1000, 1000), std::bad_alloc);
+	*budget = SIZE_MAX;
+	ASSERT_EQ(my_map.bucket_count(), buckets_count);
+	ASSERT_EQ(my_map.size(), 100);
+	ASSERT_FALSE(my_map.contains(1000));
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_EQ(my_map.at(i), i);
+	}
+	ASSERT_EQ(std::distance(my_map.begin(), my_map.end()), 100);
+	my_map.rehash(buckets_count * 10);
+	ASSERT_EQ(my_map.at(42), 42);
+	// перемещение забирает ведра и ничего не выделяет
+	decltype(my_map) other{Alloc(budget)};
+	*budget = 0;
+	other = std::move(my_map);
+	auto moved = std::move(other);
+	*budget = SIZE_MAX;
+	ASSERT_EQ(moved.size(), 100);
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_TRUE(other.empty());
+}
+
+TEST(AllocatorTest, ThrowingMultiMapRehashTest) {
+	auto budget = std::make_shared<std::size_t>(SIZE_MAX);
+	using Alloc = BudgetAllocator<std::pair<int, int>>;
+	tech::HashMultiMap<int, int, std::hash<int>, std::equal_to<int>, Alloc> my_map{Alloc(budget)};
+	for (int i = 0; i < 100; ++i) {
+		my_map.emplace(i, i);
+		my_map.emplace(i, -i);
+	}
+	auto buckets_count = my_map.bucket_count();
+	*budget = 0;
+	ASSERT_THROW(my_map.rehash(buckets_count * 10), std::bad_alloc);
+	*budget = SIZE_MAX;
+	ASSERT_EQ(my_map.bucket_count(), buckets_count);
+	ASSERT_EQ(my_map.size(), 200);
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_EQ(my_map.count(i), 2);
+	}
+	ASSERT_EQ(std::distance(my_map.begin(), my_map.end()), 200);
+	my_map.rehash(buckets_count * 10);
+	ASSERT_EQ(my_map.count(42), 2);
+}
+
+TEST(AllocatorTest, ThrowingFlatRehashTest) {
+	auto budget = std::make_shared<std::size_t>(SIZE_MAX);
+	using Alloc = BudgetAllocator<std::pair<std::string, int>>;
+	tech::FlatHashMap<std::string, int, tech::Hash<std::string>, std::equal_to<std::string>, Alloc> my_map{Alloc(budget)};
+	for (int i = 0; i < 14; ++i) {
+		my_map.emplace(std::to_string(i), i);
+	}
+	auto buckets_count = my_map.bucket_count();
+	*budget = 0;
+	ASSERT_THROW(my_map.rehash(buckets_count * 4), std::bad_alloc);
+	// слоты выделены, ctrl - нет
+	*budget = 1;
+	ASSERT_THROW(my_map.rehash(buckets_count * 4), std::bad_alloc);
+	// 14 из 16 слотов заняты, пятнадцатый элемент растит таблицу
+	*budget = 0;
+	ASSERT_THROW(my_map.emplace("14", 14), std::bad_alloc);
+	*budget = SIZE_MAX;
+	ASSERT_EQ(my_map.bucket_count(), buckets_count);
+	ASSERT_EQ(my_map.size(), 14);
+	ASSERT_FALSE(my_map.contains("14"));
+	ASSERT_EQ(std::distance(my_map.begin(), my_map.end()), 14);
+	for (int i = 0; i < 14; ++i) {
+		ASSERT_EQ(my_map.at(std::to_string(i)), i);
+	}
+	my_map.rehash(buckets_count * 4);
+	ASSERT_EQ(my_map.at("3"), 3);
+}
+
+TEST(AllocatorTest, ThrowingRobinHoodRehashTest) {
+	auto budget = std::make_shared<std::size_t>(SIZE_MAX);
+	using Alloc = BudgetAllocator<std::pair<std::string, int>>;
+	tech::RobinHoodMap<std::string, int, tech::Hash<std::string>, std::equal_to<std::string>, Alloc> my_map{Alloc(budget)};
+	for (int i = 0; i < 14; ++i) {
+		my_map.emplace(std::to_string(i), i);
+	}
+	auto buckets_count = my_map.bucket_count();
+	*budget = 0;
+	ASSERT_THROW(my_map.rehash(buckets_count * 4), std::bad_alloc);
+	*budget = 1;
+	ASSERT_THROW(my_map.rehash(buckets_count * 4), std::bad_alloc);
+	// 14 из 16 слотов заняты, пятнадцатый элемент растит таблицу
+	*budget = 0;
+	ASSERT_THROW(my_map.emplace("14", 14), std::bad_alloc);
+	*budget = SIZE_MAX;
+	ASSERT_EQ(my_map.bucket_count(), buckets_count);
+	ASSERT_EQ(my_map.size(), 14);
+	ASSERT_FALSE(my_map.contains("14"));
+	ASSERT_EQ(std::distance(my_map.begin(), my_map.end()), 14);
+	for (int i = 0; i < 14; ++i) {
+		ASSERT_EQ(my_map.at(std::to_string(i)), i);
+	}
+	my_map.rehash(buckets_count * 4);
+	ASSERT_EQ(my_map.at("3"), 3);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <libtech/concurrent_hashmap.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentHashMapTest, BasicOperationsTest) {
+	tech::ConcurrentHashMap<std::string, int> my_map(5);
+	ASSERT_EQ(my_map.shard_count(), 8);
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_TRUE(my_map.insert({"a", 1}));
+	ASSERT_FALSE(my_map.insert({"a", 2}));
+	ASSERT_TRUE(my_map.emplace("b", 2));
+	ASSERT_EQ(my_map.find("a"), 1);
+	ASSERT_EQ(my_map.find("c"), std::nullopt);
+	ASSERT_FALSE(my_map.upsert("a", [](int& value) { value += 10; }));
+	ASSERT_TRUE(my_map.upsert("c", [](int& value) { value += 10; }, 3));
+	int visited = 0;
+	ASSERT_TRUE(my_map.visit("a", [&](const int& value) { visited = value; }));
+	ASSERT_EQ(visited, 11);
+	ASSERT_EQ(my_map.find("c"), 3);
+	ASSERT_EQ(my_map.erase("b"), 1);
+	ASSERT_EQ(my_map.erase("b"), 0);
+	ASSERT_EQ(my_map.size(), 2);
+	int sum = 0;
+	my_map.for_each([&](const std::pair<std::string, int>& value) { sum += value.second; });
+	ASSERT_EQ(sum, 14);
+	my_map.clear();
+	ASSERT_TRUE(my_map.empty());
+}
+
+TEST(ConcurrentHashMapTest, ParallelUpsertTest) {
+	tech::ConcurrentHashMap<int, int> my_map;
+	constexpr int threads_count = 8;
+	constexpr int keys_count = 1000;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threads_count; ++t) {
+		threads.emplace_back([&my_map, t] {
+			for (int i = 0; i < keys_count; ++i) {
+				my_map.upsert(i, [](int& value) { ++value; }, 1);
+				if (i % threads_count == t) {
+					my_map.insert({keys_count + i, i});
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	ASSERT_EQ(my_map.size(), 2 * keys_count);
+	for (int i = 0; i < keys_count; ++i) {
+		ASSERT_EQ(my_map.find(i), threads_count);
+		ASSERT_EQ(my_map.find(keys_count + i), i);
+	}
+}
+
+// функторы с состоянием: вызов копии, построенной по умолчанию, считается ошибкой
+struct SeededHash {
+	static inline int default_calls = 0;
+	std::size_t seed = 0;
+	std::size_t operator()(int key) const {
+		default_calls += seed == 0 ? 1 : 0;
+		return std::hash<int>{}(key) ^ seed;
+	}
+};
+struct SeededEqual {
+	static inline int default_calls = 0;
+	int tag = 0;
+	bool operator()(int lhs, int rhs) const {
+		default_calls += tag == 0 ? 1 : 0;
+		return lhs == rhs;
+	}
+};
+
+TEST(ConcurrentHashMapTest, ShardFunctorsTest) {
+	tech::ConcurrentHashMap<int, int, SeededHash, SeededEqual> my_map(4, 1000, SeededHash{0x5bd1e995}, SeededEqual{1});
+	for (int i = 0; i < 1000; ++i) {
+		ASSERT_TRUE(my_map.emplace(i, i));
+	}
+	for (int i = 0; i < 1000; ++i) {
+		ASSERT_FALSE(my_map.emplace(i, -i));
+		ASSERT_EQ(my_map.find(i), i);
+	}
+	ASSERT_EQ(my_map.size(), 1000);
+	ASSERT_EQ(my_map.hash_function().seed, 0x5bd1e995);
+	ASSERT_EQ(my_map.key_eq().tag, 1);
+	ASSERT_EQ(SeededHash::default_calls, 0);
+	ASSERT_EQ(SeededEqual::default_calls, 0);
+}
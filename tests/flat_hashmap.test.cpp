@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <libtech/flat_hashmap.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+TEST(FlatHashMapTest, DefaultValuesTest) {
+	tech::FlatHashMap<std::string, int> my_map;
+	ASSERT_EQ(my_map.size(), 0);
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_EQ(my_map.begin(), my_map.end());
+	ASSERT_EQ(my_map.bucket_count() % 16, 0);
+}
+
+TEST(FlatHashMapTest, AddElementTest) {
+	tech::FlatHashMap<std::string, int> my_map;
+	my_map["somename"] = 3;
+	ASSERT_EQ(my_map["somename"], 3);
+	ASSERT_EQ(my_map.size(), 1);
+	ASSERT_TRUE(my_map.contains("somename"));
+	ASSERT_EQ(my_map.find("other"), my_map.end());
+	ASSERT_THROW(my_map.at("other"), std::out_of_range);
+	auto [it, inserted] = my_map.emplace("somename", 5);
+	ASSERT_FALSE(inserted);
+	ASSERT_EQ(it->second, 3);
+}
+
+TEST(FlatHashMapTest, RandomOperationsTest) {
+	tech::FlatHashMap<int, int> my_map;
+	std::unordered_map<int, int> std_map;
+	std::mt19937 gen(7);
+	std::uniform_int_distribution<int> keys(0, 2000);
+	for (int i = 0; i < 50000; ++i) {
+		int key = keys(gen);
+		switch (gen() % 3) {
+		case 0:
+			my_map[key] = i;
+			std_map[key] = i;
+			break;
+		case 1:
+			my_map.erase(my_map.find(key));
+			std_map.erase(key);
+			break;
+		default:
+			ASSERT_EQ(my_map.count(key), std_map.count(key));
+		}
+	}
+	ASSERT_EQ(my_map.size(), std_map.size());
+	std::size_t visited = 0;
+	for (const auto& [key, value] : my_map) {
+		ASSERT_EQ(std_map.at(key), value);
+		++visited;
+	}
+	ASSERT_EQ(visited, std_map.size());
+	ASSERT_LE(my_map.load_factor(), my_map.max_load_factor());
+}
+
+TEST(FlatHashMapTest, RehashCopyTest) {
+	tech::FlatHashMap<std::string, int> my_map = {{"a", 1}, {"b", 2}, {"c", 3}};
+	my_map.reserve(1000);
+	ASSERT_GE(my_map.bucket_count() * my_map.max_load_factor(), 1000);
+	auto copy = my_map;
+	my_map.clear();
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_EQ(copy.size(), 3);
+	ASSERT_EQ(copy.at("b"), 2);
+}
+
+struct StringHash {
+	using is_transparent = void;
+	std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+TEST(FlatHashMapTest, TransparentLookupTest) {
+	tech::FlatHashMap<std::string, int, StringHash, std::equal_to<>> my_map = {{"a", 1}, {"b", 2}};
+	std::string_view key = "a";
+	ASSERT_EQ(my_map.at(key), 1);
+	ASSERT_EQ(my_map.find(key)->first, "a");
+	ASSERT_EQ(my_map.count("c"), 0);
+	ASSERT_TRUE(my_map.try_emplace(std::string_view("c"), 3).second);
+	ASSERT_EQ(my_map["c"], 3);
+	ASSERT_EQ(my_map.erase(std::string_view("b")), 1);
+	ASSERT_FALSE(my_map.contains("b"));
+	ASSERT_EQ(my_map.size(), 2);
+}
+
+TEST(FlatHashMapTest, InsertOrAssignTest) {
+	tech::FlatHashMap<std::string, int> my_map;
+	ASSERT_TRUE(my_map.insert_or_assign("a", 1).second);
+	ASSERT_FALSE(my_map.insert_or_assign("a", 2).second);
+	ASSERT_FALSE(my_map.emplace(std::string("a"), 3).second);
+	ASSERT_EQ(my_map.emplace_hint(my_map.cbegin(), std::string("b"), 4)->second, 4);
+	ASSERT_EQ(my_map.at("a"), 2);
+	ASSERT_EQ(my_map.size(), 2);
+}
+
+// бросает из конструктора, пока включен throws
+struct FlatThrowingValue {
+	static inline bool throws = false;
+	int value;
+	FlatThrowingValue(int v = 0) : value(v) {
+		if (throws) {
+			throw std::runtime_error("FlatThrowingValue");
+		}
+	}
+};
+
+TEST(FlatHashMapTest, ThrowingConstructorTest) {
+	tech::FlatHashMap<int, FlatThrowingValue> my_map;
+	for (int i = 0; i < 14; ++i) {
+		my_map.try_emplace(i, i);
+	}
+	FlatThrowingValue::throws = true;
+	// 15-я вставка еще и растит таблицу
+	ASSERT_THROW(my_map.try_emplace(100, 1), std::runtime_error);
+	ASSERT_THROW(my_map.emplace(101, 1), std::runtime_error);
+	ASSERT_THROW(my_map[102], std::runtime_error);
+	FlatThrowingValue::throws = false;
+	ASSERT_EQ(my_map.size(), 14);
+	ASSERT_FALSE(my_map.contains(100));
+	ASSERT_FALSE(my_map.contains(101));
+	ASSERT_EQ(std::distance(my_map.begin(), my_map.end()), 14);
+	ASSERT_TRUE(my_map.try_emplace(100, 7).second);
+	ASSERT_EQ(my_map.at(100).value, 7);
+}
+
+TEST(FlatHashMapTest, MovedFromTest) {
+	tech::FlatHashMap<std::string, int> my_map = {{"a", 1}, {"b", 2}};
+	auto other = std::move(my_map);
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_FALSE(my_map.contains("a"));
+	ASSERT_EQ(my_map.find("a"), my_map.end());
+	ASSERT_EQ(my_map.erase("a"), 0);
+	ASSERT_EQ(my_map.begin(), my_map.end());
+	my_map["c"] = 3;
+	ASSERT_EQ(my_map.size(), 1);
+	ASSERT_EQ(my_map.at("c"), 3);
+	tech::FlatHashMap<std::string, int> assigned;
+	assigned = std::move(other);
+	ASSERT_FALSE(other.contains("a"));
+	ASSERT_TRUE(other.try_emplace("d", 4).second);
+	ASSERT_EQ(assigned.at("b"), 2);
+}
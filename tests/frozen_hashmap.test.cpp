@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <libtech/frozen_hashmap.hpp>
+#include <libtech/hashmap.hpp>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(FrozenHashMapTest, FileRoundTripTest) {
+	tech::HashMap<std::uint64_t, double> source;
+	for (std::uint64_t i = 0; i < 10000; ++i) {
+		source.emplace(i * 7, static_cast<double>(i) / 2);
+	}
+	auto path = std::filesystem::temp_directory_path() / "libtech_frozen_test.bin";
+	tech::FrozenHashMap<std::uint64_t, double>::save(source, path);
+	{
+		auto frozen = tech::FrozenHashMap<std::uint64_t, double>::open(path);
+		ASSERT_EQ(frozen.size(), source.size());
+		for (const auto& [key, value] : source) {
+			ASSERT_EQ(frozen.at(key), value);
+		}
+		ASSERT_FALSE(frozen.contains(3));
+		ASSERT_EQ(frozen.find(3), frozen.end());
+		ASSERT_EQ((*frozen.find(70)).second, 5);
+		ASSERT_THROW(frozen.at(3), std::out_of_range);
+		std::size_t iterated = 0;
+		for (const auto& [key, value] : frozen) {
+			ASSERT_EQ(source.at(key), value);
+			++iterated;
+		}
+		ASSERT_EQ(iterated, source.size());
+		// перемещенная карта пуста и не смотрит в чужое отображение
+		auto moved = std::move(frozen);
+		ASSERT_EQ(moved.at(70), 5);
+		ASSERT_TRUE(frozen.empty());
+		ASSERT_EQ(frozen.bucket_count(), 0);
+		ASSERT_FALSE(frozen.contains(70));
+		ASSERT_EQ(frozen.find(70), frozen.end());
+		ASSERT_EQ(frozen.begin(), frozen.end());
+		ASSERT_THROW(frozen.at(70), std::out_of_range);
+		frozen = std::move(moved);
+		ASSERT_EQ(frozen.at(70), 5);
+		ASSERT_TRUE(moved.empty());
+		// не тот тип значения
+		ASSERT_THROW((tech::FrozenHashMap<std::uint64_t, float>::open(path)), std::runtime_error);
+	}
+	std::filesystem::remove(path);
+	ASSERT_THROW((tech::FrozenHashMap<std::uint64_t, double>::open(path)), std::system_error);
+}
+
+TEST(FrozenHashMapTest, StringKeysTest) {
+	tech::HashMap<std::string, int> source;
+	for (int i = 0; i < 1000; ++i) {
+		source.emplace("key number " + std::to_string(i), i);
+	}
+	std::stringstream stream;
+	tech::FrozenHashMap<std::string, int>::save(source, stream);
+	// образ в своей памяти, выровненной на 8 байт
+	auto bytes = stream.str();
+	std::vector<std::uint64_t> image((bytes.size() + 7) / 8);
+	std::memcpy(image.data(), bytes.data(), bytes.size());
+	tech::FrozenHashMap<std::string, int> frozen(std::as_bytes(std::span(image)));
+	ASSERT_EQ(frozen.size(), 1000);
+	ASSERT_EQ(frozen.at("key number 123"), 123);
+	ASSERT_TRUE(frozen.contains(std::string_view("key number 999")));
+	ASSERT_FALSE(frozen.contains("key number 1000"));
+	int sum = 0;
+	for (const auto& [key, value] : frozen) {
+		ASSERT_EQ(key, "key number " + std::to_string(value));
+		sum += value;
+	}
+	ASSERT_EQ(sum, 999 * 1000 / 2);
+
+	image[0] = 0;
+	ASSERT_THROW((tech::FrozenHashMap<std::string, int>(std::as_bytes(std::span(image)))), std::runtime_error);
+	tech::HashMap<std::string, int> empty;
+	std::stringstream empty_stream;
+	tech::FrozenHashMap<std::string, int>::save(empty, empty_stream);
+	auto empty_bytes = empty_stream.str();
+	std::vector<std::uint64_t> empty_image((empty_bytes.size() + 7) / 8);
+	std::memcpy(empty_image.data(), empty_bytes.data(), empty_bytes.size());
+	tech::FrozenHashMap<std::string, int> frozen_empty(std::as_bytes(std::span(empty_image)));
+	ASSERT_TRUE(frozen_empty.empty());
+	ASSERT_FALSE(frozen_empty.contains("a"));
+	ASSERT_EQ(frozen_empty.begin(), frozen_empty.end());
+}
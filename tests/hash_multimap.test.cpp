@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <libtech/hash_multimap.hpp>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(HashMultiMapTest, EqualRangeTest) {
+	tech::HashMultiMap<std::string, int> my_map;
+	my_map.emplace("a", 1);
+	my_map.emplace("b", 2);
+	my_map.emplace("a", 3);
+	my_map.insert({"a", 4});
+	ASSERT_EQ(my_map.size(), 4);
+	ASSERT_EQ(my_map.count("a"), 3);
+	ASSERT_EQ(my_map.count("b"), 1);
+	ASSERT_EQ(my_map.count("c"), 0);
+	auto [first, last] = my_map.equal_range("a");
+	std::vector<int> values;
+	for (auto it = first; it != last; ++it) {
+		ASSERT_EQ(it->first, "a");
+		values.push_back(it->second);
+	}
+	std::sort(values.begin(), values.end());
+	ASSERT_EQ(values, (std::vector<int>{1, 3, 4}));
+	auto missing = my_map.equal_range("c");
+	ASSERT_EQ(missing.first, missing.second);
+	ASSERT_EQ(my_map.erase("a"), 3);
+	ASSERT_EQ(my_map.size(), 1);
+	ASSERT_FALSE(my_map.contains("a"));
+	ASSERT_EQ(my_map.find("b")->second, 2);
+}
+
+TEST(HashMultiMapTest, GroupsSurviveRehashTest) {
+	tech::HashMultiMap<int, int> my_map;
+	std::multimap<int, int> std_map;
+	std::mt19937 gen(3);
+	for (int i = 0; i < 20000; ++i) {
+		int key = static_cast<int>(gen() % 500);
+		my_map.emplace(key, i);
+		std_map.emplace(key, i);
+	}
+	ASSERT_EQ(my_map.size(), std_map.size());
+	// заполнение считается по ключам: ведер под 500 серий, а не под 20000 элементов
+	ASSERT_LE(my_map.load_factor(), my_map.max_load_factor());
+	ASSERT_LT(my_map.bucket_count(), 2000);
+	// после всех rehash каждая серия по-прежнему одна и полная
+	const auto& const_map = my_map;
+	for (int key = 0; key < 500; ++key) {
+		auto [first, last] = const_map.equal_range(key);
+		std::vector<int> values;
+		for (auto it = first; it != last; ++it) {
+			values.push_back(it->second);
+		}
+		std::vector<int> expected;
+		for (auto [it, end] = std_map.equal_range(key); it != end; ++it) {
+			expected.push_back(it->second);
+		}
+		std::sort(values.begin(), values.end());
+		ASSERT_EQ(values, expected);
+		ASSERT_EQ(my_map.count(key), expected.size());
+	}
+	std::size_t visited = 0;
+	for (auto& [key, value] : my_map) {
+		value = -value;
+		++visited;
+	}
+	ASSERT_EQ(visited, std_map.size());
+	// серия, удаленная по одному итератору, уносит ключ из заполнения
+	auto load = my_map.load_factor();
+	for (auto it = my_map.find(0); it != my_map.end() && it->first == 0; it = my_map.find(0)) {
+		my_map.erase(it);
+	}
+	ASSERT_FALSE(my_map.contains(0));
+	ASSERT_LT(my_map.load_factor(), load);
+}
+
+TEST(HashMultiMapTest, EraseIteratorCopyTest) {
+	tech::HashMultiMap<int, int> my_map = {{1, 1}, {1, 2}, {2, 3}, {3, 4}};
+	auto copy = my_map;
+	ASSERT_EQ(copy.count(1), 2);
+	// удаление одного элемента серии оставляет остальные
+	auto it = my_map.find(1);
+	my_map.erase(it);
+	ASSERT_EQ(my_map.count(1), 1);
+	ASSERT_EQ(my_map.size(), 3);
+	for (auto pos = my_map.cbegin(); pos != my_map.cend();) {
+		pos = my_map.erase(pos);
+	}
+	ASSERT_TRUE(my_map.empty());
+	my_map = std::move(copy);
+	ASSERT_EQ(my_map.size(), 4);
+	ASSERT_EQ(my_map.erase(3), 1);
+	ASSERT_EQ(my_map.erase(3), 0);
+}
+
+TEST(HashMultiMapTest, MovedFromTest) {
+	tech::HashMultiMap<std::string, int> my_map = {{"a", 1}, {"a", 2}};
+	auto other = std::move(my_map);
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_EQ(my_map.count("a"), 0);
+	auto [first, last] = my_map.equal_range("a");
+	ASSERT_EQ(first, last);
+	ASSERT_EQ(my_map.erase("a"), 0);
+	my_map.emplace("b", 3);
+	ASSERT_EQ(my_map.count("b"), 1);
+	tech::HashMultiMap<std::string, int> assigned;
+	assigned = std::move(other);
+	ASSERT_EQ(assigned.count("a"), 2);
+	ASSERT_FALSE(other.contains("a"));
+	other.emplace("c", 4);
+	ASSERT_EQ(other.size(), 1);
+}
+
+TEST(HashMultiMapTest, ParallelRehashTest) {
+	tech::HashMultiMap<int, int> my_map;
+	for (int i = 0; i < 50000; ++i) {
+		my_map.emplace(i % 5000, i);
+	}
+	// движок общий с HashMap: параллельный rehash тоже держит серии подряд
+	my_map.rehash(tech::execution::parallel_policy{4}, 100000);
+	ASSERT_GE(my_map.bucket_count(), 100000);
+	ASSERT_EQ(my_map.size(), 50000);
+	for (int key = 0; key < 5000; ++key) {
+		auto [first, last] = my_map.equal_range(key);
+		ASSERT_EQ(static_cast<std::size_t>(std::distance(first, last)), 10);
+		ASSERT_EQ(my_map.count(key), 10);
+	}
+	my_map.clear(tech::execution::parallel_policy{4});
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_FALSE(my_map.contains(0));
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <libtech/allocator.hpp>
+#include <libtech/hash_set.hpp>
+#include <libtech/hashmap.hpp>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+TEST(HashSetTest, AddElementTest) {
+	tech::HashSet<std::string> my_set;
+	ASSERT_TRUE(my_set.empty());
+	ASSERT_EQ(my_set.begin(), my_set.end());
+	ASSERT_TRUE(my_set.insert("a").second);
+	ASSERT_FALSE(my_set.insert("a").second);
+	auto [it, inserted] = my_set.emplace(std::string("b"));
+	ASSERT_TRUE(inserted);
+	ASSERT_EQ(*it, "b");
+	ASSERT_EQ(my_set.size(), 2);
+	ASSERT_TRUE(my_set.contains("a"));
+	ASSERT_EQ(my_set.count("c"), 0);
+	ASSERT_EQ(my_set.find("c"), my_set.end());
+	ASSERT_EQ(my_set.erase("a"), 1);
+	ASSERT_EQ(my_set.erase("a"), 0);
+	ASSERT_EQ(my_set.size(), 1);
+}
+
+TEST(HashSetTest, RandomOperationsTest) {
+	tech::HashSet<int> my_set;
+	std::unordered_set<int> std_set;
+	std::mt19937 gen(7);
+	std::uniform_int_distribution<int> keys(0, 2000);
+	for (int i = 0; i < 50000; ++i) {
+		int key = keys(gen);
+		switch (gen() % 3) {
+		case 0:
+			ASSERT_EQ(my_set.insert(key).second, std_set.insert(key).second);
+			break;
+		case 1:
+			if (auto it = my_set.find(key); it != my_set.end()) {
+				my_set.erase(it);
+			}
+			std_set.erase(key);
+			break;
+		default:
+			ASSERT_EQ(my_set.count(key), std_set.count(key));
+		}
+	}
+	ASSERT_EQ(my_set.size(), std_set.size());
+	std::size_t visited = 0;
+	for (auto key : my_set) {
+		ASSERT_TRUE(std_set.contains(key));
+		++visited;
+	}
+	ASSERT_EQ(visited, std_set.size());
+}
+
+TEST(HashSetTest, CopyMoveTest) {
+	tech::HashSet<std::string> my_set = {"a", "b", "c"};
+	my_set.reserve(1000);
+	ASSERT_GE(my_set.bucket_count() * my_set.max_load_factor(), 1000);
+	auto copy = my_set;
+	ASSERT_EQ(copy, my_set);
+	auto moved = std::move(my_set);
+	ASSERT_EQ(moved.size(), 3);
+	ASSERT_TRUE(moved.contains("b"));
+	copy.clear();
+	ASSERT_TRUE(copy.empty());
+	copy = moved;
+	ASSERT_EQ(copy.size(), 3);
+	// erase по итератору возвращает следующий, обход доходит до конца
+	auto it = copy.begin();
+	while (it != copy.end()) {
+		it = copy.erase(it);
+	}
+	ASSERT_TRUE(copy.empty());
+}
+
+TEST(HashSetTest, MovedFromTest) {
+	tech::HashSet<std::string> my_set = {"a", "b"};
+	auto other = std::move(my_set);
+	// перемещенное множество остается пустым и рабочим
+	ASSERT_TRUE(my_set.empty());
+	ASSERT_FALSE(my_set.contains("a"));
+	ASSERT_EQ(my_set.find("a"), my_set.end());
+	ASSERT_EQ(my_set.erase("a"), 0);
+	ASSERT_EQ(my_set.begin(), my_set.end());
+	ASSERT_TRUE(my_set.insert("c").second);
+	ASSERT_TRUE(my_set.contains("c"));
+	tech::HashSet<std::string> assigned;
+	assigned = std::move(other);
+	ASSERT_EQ(assigned.size(), 2);
+	ASSERT_FALSE(other.contains("a"));
+	ASSERT_TRUE(other.insert("d").second);
+	ASSERT_EQ(other.size(), 1);
+}
+
+TEST(HashSetTest, NodeSizeTest) {
+	// ключ без пустого bool рядом: нода множества меньше ноды HashMap<Key, bool>
+	using set_node = tech::HashSet<std::uint64_t>::node_type;
+	using map_node = tech::HashMap<std::uint64_t, bool>::node_type;
+	ASSERT_LT(sizeof(set_node), sizeof(map_node));
+	tech::HashSet<std::uint64_t, tech::Hash<std::uint64_t>, std::equal_to<std::uint64_t>, tech::PoolAllocator<std::uint64_t>> pooled;
+	for (std::uint64_t i = 0; i < 1000; ++i) {
+		pooled.insert(i);
+	}
+	ASSERT_EQ(pooled.size(), 1000);
+}
+
+struct SetStringHash {
+	using is_transparent = void;
+	std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+TEST(HashSetTest, TransparentLookupTest) {
+	tech::HashSet<std::string, SetStringHash, std::equal_to<>> my_set = {"a", "b"};
+	std::string_view key = "a";
+	ASSERT_TRUE(my_set.contains(key));
+	ASSERT_EQ(*my_set.find(key), "a");
+	ASSERT_EQ(my_set.erase(std::string_view("b")), 1);
+	ASSERT_EQ(my_set.size(), 1);
+}
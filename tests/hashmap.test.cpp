@@ -1,8 +1,19 @@
 #include <gtest/gtest.h>
 #include <iostream>
+#include <libtech/allocator.hpp>
+#include <libtech/forward_list.hpp>
 #include <libtech/hashmap.hpp>
+#include <libtech/list.hpp>
+#include <libtech/parallel.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <forward_list>
 #include <list>
+#include <random>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -155,6 +166,18 @@ template <class StringTracer> struct myhash {
 	}
 };
 
+// элементы разрушаются в порядке ведер, а он зависит от хеша, поэтому такие журналы
+// сравниваются без учета порядка строк
+std::vector<std::string> sorted_lines(const std::stringstream& stream) {
+	std::vector<std::string> lines;
+	std::istringstream input(stream.str());
+	for (std::string line; std::getline(input, line);) {
+		lines.push_back(line);
+	}
+	std::sort(lines.begin(), lines.end());
+	return lines;
+}
+
 TEST(ListTest, TwoPushBackTest) {
 	tech::List<my_Tracer> my_list;
 	std::list<std_Tracer> std_list;
@@ -220,6 +243,39 @@ TEST(ListTest, EraseTest) {
 	sexpected.str("");
 }
 
+TEST(ForwardListTest, EmplaceFrontTest) {
+	tech::ForwardList<my_StringTracer> my_list;
+	std::forward_list<std_StringTracer> std_list;
+	my_list.emplace_front("somevalue");
+	std_list.emplace_front("somevalue");
+	my_list.push_front(my_StringTracer("other"));
+	std_list.push_front(std_StringTracer("other"));
+	ASSERT_EQ(my_list.size(), 2);
+	ASSERT_EQ(my_list.front().str, "other");
+	ASSERT_EQ(sreal.str(), sexpected.str());
+	sreal.str("");
+	sexpected.str("");
+}
+
+TEST(ForwardListTest, EraseReleaseTest) {
+	tech::ForwardList<int> my_list;
+	for (int i = 0; i < 4; ++i) {
+		my_list.push_front(i);
+	}
+	auto it = my_list.begin();
+	++it;
+	my_list.erase(it); // 3 1 0
+	auto* node = my_list.release_front(); // 1 0
+	ASSERT_EQ(node->value, 3);
+	my_list.push_front(node); // 3 1 0
+	std::stringstream stest;
+	for (const auto& item : my_list) {
+		stest << item << ' ';
+	}
+	ASSERT_EQ(stest.str(), "3 1 0 ");
+	ASSERT_EQ(my_list.size(), 3);
+}
+
 TEST(VectorTest, EmplaceBackTest) {
 	tech::Vector<my_StringTracer> my_vector;
 	std::vector<std_StringTracer> std_vector;
@@ -394,17 +450,24 @@ TEST(HashMapTest, RehashMapTest2) {
 }
 
 TEST(HashMapTest, EmplaceTest) {
-	tech::HashMap<my_StringTracer, my_Tracer> my_map;
-	std::unordered_map<std_StringTracer, std_Tracer> std_map;
-	my_map.emplace("em", 2);
-	std_map.emplace("em", 2);
-	my_map.emplace("kak", 3);
-	std_map.emplace("kak", 3);
-	my_map.emplace("em", 42);
-	std_map.emplace("em", 42);
-	
-	ASSERT_EQ(my_map.at("em").value, std_map.at("em").value);
-	ASSERT_EQ(sreal.str(), sexpected.str());
+	sreal.str("");
+	sexpected.str("");
+	{
+		tech::HashMap<my_StringTracer, my_Tracer> my_map;
+		std::unordered_map<std_StringTracer, std_Tracer> std_map;
+		my_map.emplace("em", 2);
+		std_map.emplace("em", 2);
+		my_map.emplace("kak", 3);
+		std_map.emplace("kak", 3);
+		my_map.emplace("em", 42);
+		std_map.emplace("em", 42);
+
+		ASSERT_EQ(my_map.at("em").value, std_map.at("em").value);
+		ASSERT_EQ(sreal.str(), sexpected.str());
+		sreal.str("");
+		sexpected.str("");
+	}
+	ASSERT_EQ(sorted_lines(sreal), sorted_lines(sexpected));
 	sreal.str("");
 	sexpected.str("");
 }
@@ -441,15 +504,24 @@ TEST(HashMapTest, IteratorConstructor) {
 }
 
 TEST(HashMapTest, InitializerListTest) {
-	tech::HashMap<my_StringTracer, my_Tracer> my_map = {{"a", 'a'}, {"b", 'b'}, {"c", 3}};
-	std::unordered_map<std_StringTracer, std_Tracer> std_map = {{"a", 'a'}, {"b", 'b'}, {"c", 3}};
+	sreal.str("");
+	sexpected.str("");
+	{
+		tech::HashMap<my_StringTracer, my_Tracer> my_map = {{"a", 'a'}, {"b", 'b'}, {"c", 3}};
+		std::unordered_map<std_StringTracer, std_Tracer> std_map = {{"a", 'a'}, {"b", 'b'}, {"c", 3}};
 
-	ASSERT_EQ(sreal.str(), sexpected.str());
+		ASSERT_EQ(sreal.str(), sexpected.str());
+		sreal.str("");
+		sexpected.str("");
+	}
+	ASSERT_EQ(sorted_lines(sreal), sorted_lines(sexpected));
 	sreal.str("");
 	sexpected.str("");
 }
 
 TEST(HashMapTest, EraseTest) {
+	sreal.str("");
+	sexpected.str("");
 	tech::HashMap<my_StringTracer, my_Tracer> my_map = {{"a", 'a'}, {"b", 'b'}, {"c", 3}};
 	std::unordered_map<std_StringTracer, std_Tracer> std_map = {{"a", 'a'}, {"b", 'b'}, {"c", 3}};
 
@@ -478,6 +550,640 @@ TEST(HashMapTest, StdFindTest) {
 	ASSERT_EQ(result1->first, "find me");
 }
 
+TEST(HashMapTest, PowerOfTwoGrowthTest) {
+	tech::HashMap<int, int, std::hash<int>, std::equal_to<int>, std::allocator<std::pair<int, int>>, tech::PowerOfTwoGrowthPolicy<>> my_map;
+	for (int i = 0; i < 1000; ++i) {
+		my_map[i] = i;
+	}
+	ASSERT_EQ(my_map.bucket_count(), 1024);
+	ASSERT_EQ(my_map.size(), 1000);
+	for (int i = 0; i < 1000; ++i) {
+		ASSERT_EQ(my_map.at(i), i);
+	}
+	my_map.rehash(3000);
+	ASSERT_EQ(my_map.bucket_count(), 4096);
+	ASSERT_EQ(my_map.at(999), 999);
+}
+
+TEST(HashMapTest, PrimeGrowthTest) {
+	tech::HashMap<std::string, int> my_map;
+	for (int i = 0; i < 1000; ++i) {
+		my_map[std::to_string(i)] = i;
+	}
+	ASSERT_EQ(my_map.bucket_count(), tech::PrimeGrowthPolicy<>::bucket_count_for(my_map.bucket_count()));
+	ASSERT_GE(my_map.bucket_count() * my_map.max_load_factor(), my_map.size());
+	for (int i = 0; i < 1000; ++i) {
+		ASSERT_EQ(my_map.at(std::to_string(i)), i);
+	}
+	tech::PrimeGrowthPolicy<> policy;
+	std::mt19937_64 gen(42);
+	for (std::size_t prime : {1ULL, 2ULL, 97ULL, 1069ULL, 8686016335226306563ULL}) {
+		policy.reset(prime);
+		for (int i = 0; i < 1000; ++i) {
+			auto h = gen();
+			ASSERT_EQ(policy.index(h), h % prime);
+		}
+	}
+}
+
+TEST(HashMapTest, GrowthFactorTest) {
+	tech::ModuloGrowthPolicy<std::ratio<3, 2>> policy;
+	ASSERT_EQ(policy.next_bucket_count(1), 2);
+	ASSERT_EQ(policy.next_bucket_count(10), 15);
+	tech::HashMap<int, int, std::hash<int>, std::equal_to<int>, std::allocator<std::pair<int, int>>, tech::ModuloGrowthPolicy<std::ratio<3, 2>>> my_map;
+	for (int i = 0; i < 100; ++i) {
+		my_map.emplace(i, i);
+	}
+	ASSERT_EQ(my_map.size(), 100);
+	ASSERT_EQ(my_map.find(57)->second, 57);
+}
+
+struct CountingStringHash {
+	static inline int calls = 0;
+	std::size_t operator()(const std::string& str) const {
+		++calls;
+		return std::hash<std::string>{}(str);
+	}
+};
+
+struct ComparedKey {
+	static inline int compares = 0;
+	std::string str;
+	ComparedKey(const char* s) : str(s) {}
+	ComparedKey(std::string s) : str(std::move(s)) {}
+	bool operator==(const ComparedKey& other) const {
+		++compares;
+		return str == other.str;
+	}
+};
+
+TEST(HashMapTest, CachedHashRehashTest) {
+	static_assert(tech::cache_hash_code_v<std::string, std::hash<std::string>>);
+	static_assert(!tech::cache_hash_code_v<int, std::hash<int>>);
+	static_assert(sizeof(tech::HashMap<int, int>::node_type) == sizeof(std::pair<int, int>) + sizeof(void*));
+	tech::HashMap<std::string, int, CountingStringHash> my_map;
+	CountingStringHash::calls = 0;
+	for (int i = 0; i < 100; ++i) {
+		my_map.emplace(std::to_string(i), i);
+	}
+	ASSERT_EQ(CountingStringHash::calls, 100);
+	my_map.rehash(1000);
+	ASSERT_EQ(CountingStringHash::calls, 100);
+	ASSERT_EQ(my_map.at("42"), 42);
+}
+
+TEST(HashMapTest, CachedHashCompareTest) {
+	tech::HashMap<ComparedKey, int, myhash<ComparedKey>> my_map;
+	my_map.max_load_factor(100);
+	my_map.rehash(1);
+	for (int i = 0; i < 50; ++i) {
+		my_map.emplace(std::to_string(i), i);
+	}
+	ASSERT_EQ(my_map.bucket_count(), 1);
+	ComparedKey::compares = 0;
+	ASSERT_EQ(my_map.at("17"), 17);
+	ASSERT_EQ(my_map.count("missing"), 0);
+	ASSERT_EQ(ComparedKey::compares, 1);
+}
+
+struct TrackedKey {
+	static inline int constructed = 0;
+	std::string str;
+	explicit TrackedKey(std::string_view s) : str(s) { ++constructed; }
+	TrackedKey(const TrackedKey& other) : str(other.str) { ++constructed; }
+	TrackedKey(TrackedKey&&) = default;
+	bool operator==(const TrackedKey&) const = default;
+	bool operator==(std::string_view s) const { return str == s; }
+};
+
+struct TrackedKeyHash {
+	using is_transparent = void;
+	std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+	std::size_t operator()(const TrackedKey& key) const { return (*this)(std::string_view(key.str)); }
+};
+
+TEST(HashMapTest, TransparentLookupTest) {
+	tech::HashMap<TrackedKey, int, TrackedKeyHash, std::equal_to<>> my_map;
+	my_map.try_emplace(std::string_view("one"), 1);
+	my_map.try_emplace("two", 2);
+	my_map["three"] = 3;
+	TrackedKey::constructed = 0;
+	ASSERT_EQ(my_map.at(std::string_view("one")), 1);
+	ASSERT_EQ(my_map.find("two")->second, 2);
+	ASSERT_TRUE(my_map.contains("three"));
+	ASSERT_EQ(my_map.count("four"), 0);
+	ASSERT_FALSE(my_map.try_emplace("one", 10).second);
+	ASSERT_EQ(my_map["two"], 2);
+	ASSERT_EQ(my_map.erase("two"), 1);
+	ASSERT_EQ(my_map.erase("two"), 0);
+	ASSERT_EQ(TrackedKey::constructed, 0);
+	ASSERT_EQ(my_map.size(), 2);
+	ASSERT_EQ(my_map.erase(TrackedKey("one")), 1);
+	ASSERT_EQ(my_map.erase(my_map.begin()), my_map.end());
+	ASSERT_TRUE(my_map.empty());
+}
+
+TEST(HashMapTest, EmplaceExistingKeyTest) {
+	tech::Arena arena;
+	tech::HashMap<std::string, std::string, std::hash<std::string>, std::equal_to<std::string>,
+				  tech::ArenaAllocator<std::pair<std::string, std::string>>>
+		my_map(16, {}, {}, tech::ArenaAllocator<std::pair<std::string, std::string>>(arena));
+	std::string key = "some key that does not fit into sso";
+	std::pair<std::string, std::string> value(key, "value");
+	my_map.emplace(value);
+	auto allocated = arena.bytes_allocated();
+	ASSERT_FALSE(my_map.emplace(key, "other").second);
+	ASSERT_FALSE(my_map.emplace(value).second);
+	ASSERT_FALSE(my_map.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple("other")).second);
+	ASSERT_FALSE(my_map.insert(value).second);
+	ASSERT_EQ(my_map.emplace_hint(my_map.cbegin(), key, "other")->second, "value");
+	ASSERT_EQ(arena.bytes_allocated(), allocated);
+	ASSERT_EQ(my_map.size(), 1);
+	ASSERT_EQ(my_map.at(key), "value");
+}
+
+TEST(HashMapTest, InsertOrAssignTest) {
+	tech::HashMap<std::string, int> my_map;
+	auto [it, inserted] = my_map.insert_or_assign("a", 1);
+	ASSERT_TRUE(inserted);
+	ASSERT_EQ(it->second, 1);
+	std::tie(it, inserted) = my_map.insert_or_assign("a", 2);
+	ASSERT_FALSE(inserted);
+	ASSERT_EQ(it->second, 2);
+	ASSERT_EQ(my_map.size(), 1);
+	ASSERT_EQ(my_map["a"], 2);
+}
+
+TEST(HashMapTest, MovedFromTest) {
+	tech::HashMap<std::string, int> my_map = {{"a", 1}, {"b", 2}};
+	auto other = std::move(my_map);
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_FALSE(my_map.contains("a"));
+	ASSERT_EQ(my_map.find("a"), my_map.end());
+	ASSERT_EQ(my_map.begin(), my_map.end());
+	// перемещенная карта остается без ведер: move ничего не выделяет
+	static_assert(std::is_nothrow_move_constructible_v<tech::HashMap<std::string, int>>);
+	ASSERT_EQ(my_map.bucket_count(), 0);
+	ASSERT_EQ(my_map.load_factor(), 0);
+	ASSERT_EQ(my_map.count("a"), 0);
+	ASSERT_EQ(my_map.erase("a"), 0);
+	ASSERT_TRUE(my_map.extract("a").empty());
+	ASSERT_THROW(my_map.at("a"), std::out_of_range);
+	std::array<std::string, 2> keys = {"a", "b"};
+	std::array<bool, 2> found = {true, true};
+	ASSERT_EQ(my_map.contains_many(keys, found), 0);
+	ASSERT_FALSE(found[0] || found[1]);
+	auto copy = my_map;
+	ASSERT_TRUE(copy.empty());
+	copy.emplace(std::make_pair(std::string("e"), 5));
+	ASSERT_EQ(copy.at("e"), 5);
+	my_map["c"] = 3;
+	ASSERT_EQ(my_map.at("c"), 3);
+	tech::HashMap<std::string, int> assigned = {{"x", 0}};
+	assigned = std::move(other);
+	ASSERT_EQ(assigned.size(), 2);
+	ASSERT_FALSE(assigned.contains("x"));
+	ASSERT_FALSE(other.contains("a"));
+	other["d"] = 4;
+	ASSERT_EQ(other.size(), 1);
+}
+
+TEST(HashMapTest, NodeHandleTest) {
+	using Alloc = tech::ArenaAllocator<std::pair<std::string, std::string>>;
+	using Map = tech::HashMap<std::string, std::string, tech::Hash<std::string>, std::equal_to<std::string>, Alloc>;
+	tech::Arena arena;
+	Map hot(16, {}, {}, Alloc(arena));
+	Map cold(16, {}, {}, Alloc(arena));
+	for (int i = 0; i < 100; ++i) {
+		hot.emplace("key number " + std::to_string(i), "value " + std::to_string(i));
+	}
+	cold.emplace("key number 8", "old");
+	cold.reserve(200);
+	hot.reserve(200);
+	auto allocated = arena.bytes_allocated();
+	const auto* address = &*hot.find("key number 7");
+
+	auto handle = hot.extract("key number 7");
+	ASSERT_FALSE(handle.empty());
+	ASSERT_EQ(handle.mapped(), "value 7");
+	ASSERT_EQ(hot.size(), 99);
+	ASSERT_FALSE(hot.contains("key number 7"));
+	ASSERT_TRUE(hot.extract("key number 7").empty());
+	auto result = cold.insert(std::move(handle));
+	ASSERT_TRUE(result.inserted);
+	ASSERT_TRUE(result.node.empty());
+	ASSERT_EQ(&*result.position, address);
+
+	// ключ уже есть: нода возвращается
+	result = cold.insert(hot.extract(hot.find("key number 8")));
+	ASSERT_FALSE(result.inserted);
+	ASSERT_EQ(result.node.key(), "key number 8");
+	ASSERT_EQ(result.position->second, "old");
+	ASSERT_TRUE(hot.insert(std::move(result.node)).inserted);
+
+	cold.merge(hot);
+	ASSERT_EQ(cold.size(), 100);
+	ASSERT_EQ(hot.size(), 1);
+	ASSERT_TRUE(hot.contains("key number 8"));
+	ASSERT_EQ(cold.at("key number 50"), "value 50");
+	ASSERT_EQ(arena.bytes_allocated(), allocated);
+	std::size_t iterated = 0;
+	for ([[maybe_unused]] auto& item : hot) {
+		++iterated;
+	}
+	ASSERT_EQ(iterated, 1);
+}
+
+// хешер с состоянием: у карт с разными seed хеши одного ключа разные
+struct SeededStringHash {
+	std::uint64_t seed = 0;
+	std::size_t operator()(const std::string& key) const { return tech::hash_bytes(key, seed); }
+};
+
+TEST(HashMapTest, SeededNodeTransferTest) {
+	using Map = tech::HashMap<std::string, int, SeededStringHash>;
+	Map source(16, SeededStringHash{1});
+	Map target(16, SeededStringHash{2});
+	for (int i = 0; i < 100; ++i) {
+		source.emplace("key " + std::to_string(i), i);
+	}
+	auto result = target.insert(source.extract("key 0"));
+	ASSERT_TRUE(result.inserted);
+	// ключ, поменянный в handle, хешируется заново
+	auto handle = source.extract("key 1");
+	handle.key() = "renamed";
+	ASSERT_TRUE(source.insert(std::move(handle)).inserted);
+	ASSERT_EQ(source.at("renamed"), 1);
+	ASSERT_FALSE(source.contains("key 1"));
+	target.merge(source);
+	ASSERT_TRUE(source.empty());
+	ASSERT_EQ(target.size(), 100);
+	for (int i = 2; i < 100; ++i) {
+		ASSERT_EQ(target.at("key " + std::to_string(i)), i);
+	}
+	ASSERT_EQ(target.at("key 0"), 0);
+	ASSERT_EQ(target.at("renamed"), 1);
+	target.rehash(1000);
+	ASSERT_EQ(target.at("key 50"), 50);
+}
+
+struct Point {
+	std::string name;
+	int x;
+};
+template <> struct tech::serializer<Point> {
+	static void write(tech::BinaryWriter& writer, const Point& point) {
+		tech::serializer<std::string>::write(writer, point.name);
+		writer.write_value(point.x);
+	}
+	static Point read(tech::BinaryReader& reader) {
+		auto name = tech::serializer<std::string>::read(reader);
+		return {std::move(name), reader.read_value<int>()};
+	}
+};
+
+TEST(HashMapTest, SerializationTest) {
+	tech::HashMap<std::uint64_t, double> numbers;
+	for (std::uint64_t i = 0; i < 10000; ++i) {
+		numbers.emplace(i * 3, static_cast<double>(i) / 4);
+	}
+	std::stringstream stream;
+	numbers.save(stream);
+	stream << "tail";
+	tech::HashMap<std::uint64_t, double> loaded;
+	loaded.emplace(1, 1);
+	loaded.load(stream);
+	ASSERT_EQ(loaded.size(), numbers.size());
+	ASSERT_EQ(loaded.bucket_count(), numbers.bucket_count());
+	for (const auto& [key, value] : numbers) {
+		ASSERT_EQ(loaded.at(key), value);
+	}
+	ASSERT_FALSE(loaded.contains(1));
+	// поток стоит сразу за картой
+	std::string tail;
+	stream >> tail;
+	ASSERT_EQ(tail, "tail");
+
+	tech::HashMap<std::string, Point> points;
+	for (int i = 0; i < 100; ++i) {
+		points.emplace("point " + std::to_string(i), Point{"name " + std::to_string(i), i});
+	}
+	std::stringstream points_stream;
+	points.save(points_stream);
+	auto bytes = points_stream.str();
+	tech::HashMap<std::string, Point> loaded_points;
+	loaded_points.load(points_stream);
+	ASSERT_EQ(loaded_points.size(), 100);
+	ASSERT_EQ(loaded_points.at("point 42").name, "name 42");
+	ASSERT_EQ(loaded_points.at("point 42").x, 42);
+
+	// обрезанные данные: исключение, карта не меняется
+	std::stringstream truncated(bytes.substr(0, bytes.size() / 2));
+	ASSERT_THROW(loaded_points.load(truncated), std::runtime_error);
+	ASSERT_EQ(loaded_points.size(), 100);
+	std::stringstream garbage("not a hashmap at all");
+	ASSERT_THROW(loaded_points.load(garbage), std::runtime_error);
+}
+
+TEST(HashMapTest, SparseIterationTest) {
+	tech::HashMap<int, int> my_map;
+	my_map.rehash(100000);
+	ASSERT_EQ(my_map.begin(), my_map.end());
+	for (int i = 0; i < 1000; i += 7) {
+		my_map.emplace(i, i);
+	}
+	std::size_t visited = 0;
+	long long sum = 0;
+	for (const auto& [key, value] : my_map) {
+		++visited;
+		sum += value;
+	}
+	ASSERT_EQ(visited, my_map.size());
+	ASSERT_EQ(sum, 143 * 994 / 2);
+	for (int i = 0; i < 500; i += 7) {
+		ASSERT_EQ(my_map.erase(i), 1);
+	}
+	ASSERT_GE(my_map.begin()->first, 500);
+	while (!my_map.empty()) {
+		my_map.erase(my_map.begin());
+	}
+	ASSERT_EQ(my_map.begin(), my_map.end());
+	my_map.emplace(3, 3);
+	ASSERT_EQ(my_map.begin()->first, 3);
+	auto copy = my_map;
+	my_map.clear();
+	ASSERT_EQ(my_map.begin(), my_map.end());
+	ASSERT_EQ(copy.begin()->first, 3);
+	ASSERT_EQ(++copy.begin(), copy.end());
+}
+
+TEST(HashMapTest, BulkInsertTest) {
+	std::vector<std::pair<std::string, int>> values;
+	for (int i = 0; i < 1000; ++i) {
+		values.emplace_back(std::to_string(i % 700), i);
+	}
+	tech::HashMap<std::string, int> my_map = {{"5", -5}};
+	ASSERT_EQ(my_map.bulk_insert(values.begin(), values.end()), 699);
+	ASSERT_EQ(my_map.size(), 700);
+	ASSERT_EQ(my_map.at("5"), -5);
+	ASSERT_EQ(my_map.at("10"), 10);
+	ASSERT_GE(my_map.bucket_count() * my_map.max_load_factor(), my_map.size());
+	std::forward_list<std::pair<std::string, int>> list(values.begin(), values.end());
+	tech::HashMap<std::string, int> from_list(list.begin(), list.end());
+	ASSERT_EQ(from_list.size(), 700);
+	ASSERT_EQ(from_list.at("5"), 5);
+}
+
+TEST(HashMapTest, ParallelBulkInsertTest) {
+	std::vector<std::pair<int, int>> values;
+	std::mt19937 gen(7);
+	for (int i = 0; i < 200000; ++i) {
+		values.emplace_back(static_cast<int>(gen() % 150000), i);
+	}
+	auto parallel = tech::HashMap<int, int>::build_from(tech::execution::parallel_policy{4}, values.begin(), values.end());
+	tech::HashMap<int, int> sequential;
+	sequential.bulk_insert(tech::execution::seq, values.begin(), values.end());
+	ASSERT_EQ(parallel.size(), sequential.size());
+	std::size_t visited = 0;
+	for (const auto& [key, value] : parallel) {
+		ASSERT_EQ(sequential.at(key), value);
+		++visited;
+	}
+	ASSERT_EQ(visited, parallel.size());
+	ASSERT_EQ(parallel.bulk_insert(tech::execution::par, values.begin(), values.end()), 0);
+}
+
+TEST(HashMapTest, ParallelRehashTest) {
+	tech::HashMap<std::string, int> my_map;
+	for (int i = 0; i < 200000; ++i) {
+		my_map.emplace(std::to_string(i), i);
+	}
+	auto check = [&] {
+		std::size_t in_buckets = 0;
+		for (std::size_t i = 0; i < my_map.bucket_count(); ++i) {
+			in_buckets += my_map.bucket_size(i);
+		}
+		ASSERT_EQ(in_buckets, 200000);
+		std::size_t iterated = 0;
+		for (const auto& [key, value] : my_map) {
+			ASSERT_EQ(key, std::to_string(value));
+			++iterated;
+		}
+		ASSERT_EQ(iterated, 200000);
+		for (int i = 0; i < 200000; i += 7) {
+			ASSERT_EQ(my_map.at(std::to_string(i)), i);
+		}
+	};
+	my_map.rehash(tech::execution::parallel_policy{4}, 1000000);
+	ASSERT_GE(my_map.bucket_count(), 1000000);
+	check();
+	// уменьшение: ноды снова перераскладываются по полосам
+	my_map.rehash(tech::execution::parallel_policy{3}, 0);
+	ASSERT_LT(my_map.bucket_count(), 1000000);
+	check();
+
+	my_map.clear(tech::execution::parallel_policy{4});
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_EQ(my_map.begin(), my_map.end());
+	ASSERT_FALSE(my_map.contains("1"));
+	my_map.emplace("1", 1);
+	ASSERT_EQ(my_map.size(), 1);
+	ASSERT_EQ(my_map.begin()->second, 1);
+}
+
+TEST(HashMapTest, BucketRangeTest) {
+	tech::HashMap<int, int> my_map;
+	for (int i = 0; i < 5000; ++i) {
+		my_map.emplace(i, i);
+	}
+	// куски с произвольными границами покрывают карту ровно один раз
+	std::vector<int> seen(5000, 0);
+	for (std::size_t begin = 0; begin < my_map.bucket_count(); begin += 100) {
+		for (const auto& [key, value] : std::as_const(my_map).bucket_range(begin, begin + 100)) {
+			++seen[key];
+		}
+	}
+	ASSERT_EQ(std::count(seen.begin(), seen.end(), 1), 5000);
+	ASSERT_TRUE(my_map.bucket_range(7, 7).empty());
+	ASSERT_TRUE(my_map.bucket_range(my_map.bucket_count(), my_map.bucket_count() + 10).empty());
+	std::size_t all = 0;
+	for (auto& value : my_map.bucket_range(0, my_map.bucket_count())) {
+		value.second = -value.second;
+		++all;
+	}
+	ASSERT_EQ(all, 5000);
+	ASSERT_EQ(my_map.at(42), -42);
+}
+
+TEST(HashMapTest, ParallelForEachTest) {
+	// неравные ведра: большие ключи все в одном ведре
+	struct SkewedHash {
+		std::size_t operator()(std::uint64_t key) const { return key >= 1000000000ull ? 0 : key; }
+	};
+	tech::HashMap<std::uint64_t, std::uint64_t, SkewedHash> my_map;
+	for (std::uint64_t i = 0; i < 200000; ++i) {
+		my_map.emplace(i, i);
+	}
+	for (std::uint64_t i = 1; i <= 2000; ++i) {
+		my_map.emplace(1000000000ull + i, 0);
+	}
+	ASSERT_GE(my_map.stats().max_chain, 2000);
+	tech::parallel_for_each(tech::execution::parallel_policy{4}, my_map, [](auto& value) { value.second *= 2; });
+	ASSERT_EQ(my_map.at(12345), 24690);
+	auto sum = tech::parallel_reduce(tech::execution::parallel_policy{4}, my_map, std::uint64_t{0},
+									 [](std::uint64_t acc, const auto& value) { return acc + value.second; });
+	std::uint64_t expected = 0;
+	for (const auto& value : my_map) {
+		expected += value.second;
+	}
+	ASSERT_EQ(sum, expected);
+	// свой combine: максимум ключа
+	auto max_key = tech::parallel_reduce(
+		my_map, std::uint64_t{0}, [](std::uint64_t acc, const auto& value) { return std::max(acc, value.first); },
+		[](std::uint64_t a, std::uint64_t b) { return std::max(a, b); });
+	ASSERT_EQ(max_key, 1000000000ull + 2000);
+	// init учитывается один раз при любом числе потоков
+	for (std::size_t threads : {1, 4, 16}) {
+		ASSERT_EQ(tech::parallel_reduce(tech::execution::parallel_policy{threads}, my_map, std::uint64_t{10},
+										[](std::uint64_t acc, const auto& value) { return acc + value.second; }),
+				  expected + 10);
+	}
+	ASSERT_EQ(tech::parallel_reduce(tech::execution::seq, my_map, std::size_t{0},
+									[](std::size_t acc, const auto&) { return acc + 1; }),
+			  my_map.size());
+
+	// исключение из fn доходит до вызывающего, остальные потоки дорабатывают свои куски
+	ASSERT_THROW(tech::parallel_for_each(tech::execution::parallel_policy{4}, my_map,
+										 [](const auto& value) {
+											 if (value.first == 777) {
+												 throw std::runtime_error("fn");
+											 }
+										 }),
+				 std::runtime_error);
+}
+
+TEST(HashMapTest, FindManyTest) {
+	tech::HashMap<std::string, int> my_map;
+	for (int i = 0; i < 1000; i += 2) {
+		my_map.emplace(std::to_string(i), i);
+	}
+	std::vector<std::string> keys;
+	for (int i = 0; i < 100; ++i) {
+		keys.push_back(std::to_string(i * 7));
+	}
+	std::vector<tech::HashMap<std::string, int>::iterator> iterators(keys.size());
+	my_map.find_many(keys, iterators);
+	std::vector<int*> values(keys.size());
+	my_map.find_many(keys, values);
+	bool flags[100];
+	ASSERT_EQ(my_map.contains_many(keys, flags), 50);
+	for (std::size_t i = 0; i < keys.size(); ++i) {
+		ASSERT_EQ(iterators[i], my_map.find(keys[i]));
+		ASSERT_EQ(flags[i], my_map.contains(keys[i]));
+		ASSERT_EQ(values[i] != nullptr, flags[i]);
+		if (values[i]) {
+			ASSERT_EQ(*values[i], std::stoi(keys[i]));
+		}
+	}
+	const auto& const_map = my_map;
+	std::vector<tech::HashMap<std::string, int>::const_iterator> const_iterators(keys.size(), const_map.end());
+	const_map.find_many(keys, const_iterators);
+	ASSERT_EQ(const_iterators[2]->second, 14);
+	// короткий results не пишется за границу
+	std::vector<int*> short_values(keys.size() - 1);
+	ASSERT_THROW(my_map.find_many(keys, short_values), std::length_error);
+	ASSERT_THROW(my_map.contains_many(keys, std::span<bool>(flags, 10)), std::length_error);
+}
+
+TEST(HashMapTest, HashTest) {
+	static_assert(tech::is_avalanching_v<tech::Hash<int>>);
+	static_assert(tech::is_avalanching_v<tech::Hash<std::string>>);
+	static_assert(!tech::is_avalanching_v<std::hash<int>>);
+	tech::Hash<std::string> string_hash;
+	ASSERT_EQ(string_hash(std::string("hello world")), tech::Hash<std::string_view>{}("hello world"));
+	ASSERT_NE(string_hash("hello world"), string_hash("hello worle"));
+	ASSERT_NE(string_hash(std::string(100, 'a')), string_hash(std::string(101, 'a')));
+	ASSERT_EQ(tech::Hash<double>{}(0.0), tech::Hash<double>{}(-0.0));
+	static_assert(tech::hash_bytes("abc") == tech::hash_bytes("abc"));
+
+	// последовательные id со степенью двойки ведер: без перемешивания младшие биты совпали бы
+	std::vector<std::size_t> per_bucket(1024);
+	tech::Hash<std::uint64_t> int_hash;
+	for (std::uint64_t id = 0; id < 1024 * 16; ++id) {
+		++per_bucket[int_hash(id << 10) & 1023];
+	}
+	ASSERT_LT(*std::max_element(per_bucket.begin(), per_bucket.end()), 48U);
+
+	tech::HashMap<std::string, int, tech::Hash<std::string>, std::equal_to<>> my_map;
+	for (int i = 0; i < 1000; ++i) {
+		my_map.emplace(std::to_string(i), i);
+	}
+	ASSERT_EQ(my_map.find(std::string_view("123"))->second, 123);
+	ASSERT_TRUE(my_map.contains("999"));
+	ASSERT_FALSE(my_map.contains("1000"));
+}
+
+TEST(HashMapTest, StatsTest) {
+	using counted_map = tech::HashMap<int, int, tech::Hash<int>, std::equal_to<int>, std::allocator<std::pair<int, int>>,
+									  tech::PrimeGrowthPolicy<>, tech::CountingStatsPolicy>;
+	counted_map my_map;
+	for (int i = 0; i < 1000; ++i) {
+		my_map.emplace(i, i);
+	}
+	for (int i = 0; i < 1500; ++i) {
+		my_map.contains(i);
+	}
+	ASSERT_EQ(my_map.find(1)->second, 1);
+	ASSERT_THROW(my_map.at(-1), std::out_of_range);
+	auto stats = my_map.stats();
+	// каждая вставка тоже ищет ключ: 1000 промахов
+	ASSERT_EQ(stats.lookups, 2502);
+	ASSERT_EQ(stats.hits, 1001);
+	ASSERT_EQ(stats.misses, 1501);
+	ASSERT_GT(stats.rehashes, 0);
+	// ноды, массивы ведер и битмапы, включая начальные
+	ASSERT_EQ(stats.allocations, 1000 + 2 * (stats.rehashes + 1));
+	ASSERT_GE(stats.allocated_bytes, 1000 * sizeof(counted_map::node_type));
+	ASSERT_EQ(stats.size, 1000);
+	std::size_t buckets = 0;
+	std::size_t items = 0;
+	for (std::size_t k = 0; k < stats.chain_lengths.size(); ++k) {
+		buckets += stats.chain_lengths[k];
+		items += k * stats.chain_lengths[k];
+	}
+	ASSERT_EQ(buckets, my_map.bucket_count());
+	ASSERT_EQ(items, my_map.size());
+	ASSERT_GE(stats.max_chain, 1);
+
+	std::stringstream out;
+	my_map.dump_stats(out);
+	ASSERT_NE(out.str().find("hits 1001\n"), std::string::npos);
+	ASSERT_NE(out.str().find("chain_length_15_or_more "), std::string::npos);
+
+	// поиск внутри operator[], try_emplace, erase и extract тоже считается
+	my_map[0] = 1;
+	my_map.try_emplace(1000, 0);
+	ASSERT_EQ(my_map.erase(1000), 1);
+	ASSERT_TRUE(my_map.extract(-1).empty());
+	ASSERT_EQ(my_map.stats().lookups, stats.lookups + 4);
+	ASSERT_EQ(my_map.stats().hits, stats.hits + 2);
+	// массив хешей bulk_insert тоже выделение
+	counted_map bulk(127);
+	std::vector<std::pair<int, int>> values(100, {1, 1});
+	auto before = bulk.stats();
+	bulk.insert(values.begin(), values.end());
+	ASSERT_EQ(bulk.stats().allocations, before.allocations + 2);
+	ASSERT_EQ(bulk.stats().allocated_bytes - before.allocated_bytes, 100 * sizeof(std::size_t) + sizeof(counted_map::node_type));
+
+	// копия считает с нуля, без политики счетчики нулевые, а форма таблицы есть
+	auto copy = my_map;
+	ASSERT_EQ(copy.stats().lookups, 0);
+	tech::HashMap<int, int> plain(my_map.begin(), my_map.end());
+	plain.contains(1);
+	ASSERT_EQ(plain.stats().lookups, 0);
+	ASSERT_EQ(plain.stats().size, 1000);
+}
+
 int main(int argc, char** argv) {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
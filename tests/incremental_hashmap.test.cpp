@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <libtech/allocator.hpp>
+#include <libtech/incremental_hashmap.hpp>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TEST(IncrementalHashMapTest, BasicOperationsTest) {
+	tech::IncrementalHashMap<std::string, int> my_map;
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_TRUE(my_map.insert({"a", 1}).second);
+	ASSERT_FALSE(my_map.emplace("a", 2).second);
+	ASSERT_TRUE(my_map.try_emplace("b", 2).second);
+	my_map["c"] = 3;
+	ASSERT_FALSE(my_map.insert_or_assign("c", 4).second);
+	ASSERT_EQ(my_map.at("c"), 4);
+	ASSERT_THROW(my_map.at("d"), std::out_of_range);
+	ASSERT_EQ(my_map.find("a")->second, 1);
+	ASSERT_EQ(my_map.find("d"), my_map.end());
+	ASSERT_EQ(my_map.erase("b"), 1);
+	ASSERT_EQ(my_map.erase("b"), 0);
+	ASSERT_EQ(my_map.size(), 2);
+	auto copy = my_map;
+	auto moved = std::move(my_map);
+	ASSERT_EQ(copy.size(), 2);
+	ASSERT_EQ(moved.at("a"), 1);
+	ASSERT_FALSE(my_map.contains("a"));
+	my_map["x"] = 1;
+	ASSERT_EQ(my_map.size(), 1);
+	moved.clear();
+	ASSERT_TRUE(moved.empty());
+	ASSERT_EQ(moved.begin(), moved.end());
+}
+
+TEST(IncrementalHashMapTest, CopyAfterMoveTest) {
+	tech::IncrementalHashMap<std::string, int> my_map = {{"a", 1}};
+	auto moved = std::move(my_map);
+	// у перемещенной карты нет таблицы, копия все равно получает ведра
+	tech::IncrementalHashMap<std::string, int> copy(my_map);
+	ASSERT_TRUE(copy.empty());
+	ASSERT_GT(copy.bucket_count(), 0);
+	copy.emplace("b", 2);
+	ASSERT_EQ(copy.at("b"), 2);
+	moved = my_map;
+	ASSERT_TRUE(moved.empty());
+	moved["c"] = 3;
+	ASSERT_EQ(moved.size(), 1);
+}
+
+// случайные операции вперемешку с переносом ведер, сверяем с std::unordered_map
+TEST(IncrementalHashMapTest, RandomOperationsDuringRehashTest) {
+	tech::IncrementalHashMap<int, int> my_map;
+	std::unordered_map<int, int> std_map;
+	std::mt19937 gen(42);
+	std::uniform_int_distribution<int> keys(0, 20000);
+	bool seen_rehashing = false;
+	for (int step = 0; step < 100000; ++step) {
+		auto key = keys(gen);
+		switch (gen() % 4) {
+		case 0:
+		case 1:
+			ASSERT_EQ(my_map.emplace(key, step).second, std_map.emplace(key, step).second);
+			break;
+		case 2:
+			ASSERT_EQ(my_map.erase(key), std_map.erase(key));
+			break;
+		default:
+			ASSERT_EQ(my_map.find(key) == my_map.end(), !std_map.contains(key));
+		}
+		seen_rehashing |= my_map.is_rehashing();
+		if (my_map.is_rehashing() && step % 97 == 0) {
+			// обход посреди переноса видит каждый элемент ровно один раз
+			std::size_t visited = 0;
+			for (const auto& [k, v] : my_map) {
+				ASSERT_EQ(std_map.at(k), v);
+				++visited;
+			}
+			ASSERT_EQ(visited, std_map.size());
+		}
+	}
+	ASSERT_TRUE(seen_rehashing);
+	ASSERT_EQ(my_map.size(), std_map.size());
+	my_map.finish_rehash();
+	ASSERT_FALSE(my_map.is_rehashing());
+	for (const auto& [k, v] : std_map) {
+		ASSERT_EQ(my_map.at(k), v);
+	}
+}
+
+TEST(IncrementalHashMapTest, EraseByIteratorDuringRehashTest) {
+	tech::PoolAllocator<std::pair<std::string, int>> alloc;
+	tech::IncrementalHashMap<std::string, int, tech::Hash<std::string>, std::equal_to<std::string>,
+							 tech::PoolAllocator<std::pair<std::string, int>>>
+		my_map(1, {}, {}, alloc);
+	for (int i = 0; i < 1100; ++i) {
+		my_map.emplace(std::to_string(i), i);
+	}
+	// таблица выросла с 1024 ведер на 1025-м элементе, перенос еще идет
+	ASSERT_TRUE(my_map.is_rehashing());
+	for (auto it = my_map.begin(); it != my_map.end();) {
+		it = it->second % 2 ? my_map.erase(it) : ++it;
+	}
+	ASSERT_EQ(my_map.size(), 550);
+	my_map.reserve(10000);
+	ASSERT_FALSE(my_map.is_rehashing());
+	ASSERT_GE(my_map.bucket_count(), 10000);
+	for (int i = 0; i < 1100; ++i) {
+		ASSERT_EQ(my_map.contains(std::to_string(i)), i % 2 == 0);
+	}
+}
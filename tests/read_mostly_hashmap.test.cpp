@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <libtech/read_mostly_hashmap.hpp>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ReadMostlyHashMapTest, BasicOperationsTest) {
+	tech::ReadMostlyHashMap<std::string, int> my_map;
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_TRUE(my_map.insert({"a", 1}));
+	ASSERT_FALSE(my_map.insert({"a", 2}));
+	ASSERT_TRUE(my_map.emplace("b", 2));
+	ASSERT_EQ(my_map.find("a"), 1);
+	ASSERT_EQ(my_map.find("c"), std::nullopt);
+	ASSERT_FALSE(my_map.insert_or_assign("b", 20));
+	ASSERT_EQ(my_map.find("b"), 20);
+	ASSERT_FALSE(my_map.upsert("a", [](int& value) { value += 10; }));
+	ASSERT_TRUE(my_map.upsert("c", [](int& value) { value += 10; }, 3));
+	int visited = 0;
+	ASSERT_TRUE(my_map.visit("a", [&](const int& value) { visited = value; }));
+	ASSERT_EQ(visited, 11);
+	ASSERT_EQ(my_map.erase("b"), 1);
+	ASSERT_EQ(my_map.erase("b"), 0);
+	ASSERT_EQ(my_map.size(), 2);
+	for (int i = 0; i < 1000; ++i) {
+		my_map.emplace(std::to_string(i), i);
+	}
+	ASSERT_GE(my_map.bucket_count(), 1002);
+	int sum = 0;
+	my_map.for_each([&](const std::pair<std::string, int>& value) { sum += value.second; });
+	ASSERT_EQ(sum, 11 + 3 + 999 * 1000 / 2);
+	my_map.clear();
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_FALSE(my_map.contains("a"));
+	my_map.reserve(5000);
+	ASSERT_GE(my_map.bucket_count(), 5000);
+}
+
+// читатели без блокировок против писателей, заменяющих и удаляющих ноды, пока таблица растет.
+// Постоянные ключи должны находиться всегда, значение всегда согласовано с ключом.
+// Под ASan освобождение ноды, которую еще читают, видно сразу
+TEST(ReadMostlyHashMapTest, ConcurrentStressTest) {
+	constexpr int permanent_keys = 512;
+	constexpr int all_keys = 8192;
+	constexpr int writers_count = 2;
+	constexpr int readers_count = 4;
+	auto value_for = [](int key, int version) { return std::to_string(key) + "/" + std::to_string(version); };
+	auto matches = [](int key, const std::string& value) {
+		auto prefix = std::to_string(key) + "/";
+		return value.compare(0, prefix.size(), prefix) == 0;
+	};
+	for (int round = 0; round < 3; ++round) {
+		tech::ReadMostlyHashMap<int, std::string> my_map;
+		for (int key = 0; key < permanent_keys; ++key) {
+			my_map.emplace(key, value_for(key, 0));
+		}
+		std::atomic<bool> stop = false;
+		std::atomic<int> errors = 0;
+		std::vector<std::thread> threads;
+		for (int r = 0; r < readers_count; ++r) {
+			threads.emplace_back([&, r] {
+				std::mt19937 gen(r);
+				while (!stop.load(std::memory_order_relaxed)) {
+					int key = static_cast<int>(gen() % all_keys);
+					auto value = my_map.find(key);
+					if ((key < permanent_keys && !value) || (value && !matches(key, *value))) {
+						errors.fetch_add(1);
+					}
+				}
+			});
+		}
+		for (int w = 0; w < writers_count; ++w) {
+			threads.emplace_back([&, w] {
+				std::mt19937 gen(100 + w);
+				for (int step = 0; step < 20000; ++step) {
+					int key = static_cast<int>(gen() % all_keys);
+					if (key < permanent_keys) {
+						my_map.insert_or_assign(key, value_for(key, step));
+					} else if (gen() % 3 == 0) {
+						my_map.erase(key);
+					} else {
+						my_map.upsert(key, [&](std::string& value) { value = value_for(key, step); }, value_for(key, step));
+					}
+				}
+			});
+		}
+		for (int i = readers_count; i < readers_count + writers_count; ++i) {
+			threads[i].join();
+		}
+		stop = true;
+		for (int i = 0; i < readers_count; ++i) {
+			threads[i].join();
+		}
+		ASSERT_EQ(errors.load(), 0);
+		ASSERT_GT(my_map.bucket_count(), permanent_keys);
+		std::size_t counted = 0;
+		my_map.for_each([&](const std::pair<int, std::string>& value) {
+			ASSERT_TRUE(matches(value.first, value.second));
+			++counted;
+		});
+		ASSERT_EQ(counted, my_map.size());
+	}
+}
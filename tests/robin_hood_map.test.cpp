@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <libtech/robin_hood_map.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+TEST(RobinHoodMapTest, DefaultValuesTest) {
+	tech::RobinHoodMap<std::string, int> my_map;
+	ASSERT_EQ(my_map.size(), 0);
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_EQ(my_map.begin(), my_map.end());
+	ASSERT_EQ(my_map.max_probe_length(), 0);
+	ASSERT_EQ(my_map.average_probe_length(), 0);
+}
+
+TEST(RobinHoodMapTest, AddElementTest) {
+	tech::RobinHoodMap<std::string, int> my_map;
+	my_map["somename"] = 3;
+	ASSERT_EQ(my_map["somename"], 3);
+	ASSERT_EQ(my_map.size(), 1);
+	ASSERT_TRUE(my_map.contains("somename"));
+	ASSERT_EQ(my_map.find("other"), my_map.end());
+	ASSERT_THROW(my_map.at("other"), std::out_of_range);
+	auto [it, inserted] = my_map.emplace("somename", 5);
+	ASSERT_FALSE(inserted);
+	ASSERT_EQ(it->second, 3);
+	ASSERT_EQ(my_map.max_probe_length(), 1);
+}
+
+TEST(RobinHoodMapTest, RandomOperationsTest) {
+	tech::RobinHoodMap<int, int> my_map;
+	my_map.max_load_factor(0.95F);
+	std::unordered_map<int, int> std_map;
+	std::mt19937 gen(7);
+	std::uniform_int_distribution<int> keys(0, 2000);
+	for (int i = 0; i < 50000; ++i) {
+		int key = keys(gen);
+		switch (gen() % 3) {
+		case 0:
+			my_map[key] = i;
+			std_map[key] = i;
+			break;
+		case 1:
+			my_map.erase(my_map.find(key));
+			std_map.erase(key);
+			break;
+		default:
+			ASSERT_EQ(my_map.count(key), std_map.count(key));
+		}
+	}
+	ASSERT_EQ(my_map.size(), std_map.size());
+	std::size_t visited = 0;
+	for (const auto& [key, value] : my_map) {
+		ASSERT_EQ(std_map.at(key), value);
+		++visited;
+	}
+	ASSERT_EQ(visited, std_map.size());
+	ASSERT_LE(my_map.load_factor(), my_map.max_load_factor());
+}
+
+// ключи с одним домом: каждый следующий уходит дальше, удаление подтягивает хвост
+struct CollidingHash {
+	using is_avalanching = void;
+	std::size_t operator()(int key) const { return key < 100 ? 5 : static_cast<std::size_t>(key); }
+};
+
+TEST(RobinHoodMapTest, BackwardShiftTest) {
+	tech::RobinHoodMap<int, int, CollidingHash> my_map(64);
+	for (int i = 0; i < 10; ++i) {
+		my_map.emplace(i, i);
+	}
+	ASSERT_EQ(my_map.max_probe_length(), 10);
+	ASSERT_DOUBLE_EQ(my_map.average_probe_length(), 5.5);
+	ASSERT_EQ(my_map.erase(0), 1);
+	// без надгробий дистанции сразу короче
+	ASSERT_EQ(my_map.max_probe_length(), 9);
+	for (int i = 1; i < 10; ++i) {
+		ASSERT_EQ(my_map.at(i), i);
+	}
+	// erase по итератору возвращает элемент, сдвинутый на место удаленного
+	auto it = my_map.find(4);
+	auto next = my_map.erase(it);
+	ASSERT_NE(next, my_map.end());
+	ASSERT_EQ(next->first, 5);
+	ASSERT_FALSE(my_map.contains(4));
+	ASSERT_EQ(my_map.size(), 8);
+	ASSERT_EQ(my_map.find(100), my_map.end());
+}
+
+TEST(RobinHoodMapTest, HighLoadFactorTest) {
+	tech::RobinHoodMap<std::uint64_t, std::uint64_t> my_map;
+	my_map.max_load_factor(0.95F);
+	my_map.rehash(1 << 16);
+	ASSERT_EQ(my_map.bucket_count(), 1 << 16);
+	const std::size_t count = (1 << 16) * 95 / 100;
+	for (std::uint64_t i = 0; i < count; ++i) {
+		my_map.emplace(i * 7919, i);
+	}
+	ASSERT_EQ(my_map.bucket_count(), 1 << 16);
+	ASSERT_GT(my_map.load_factor(), 0.94F);
+	ASSERT_LT(my_map.average_probe_length(), 16);
+	for (std::uint64_t i = 0; i < count; i += 13) {
+		ASSERT_EQ(my_map.at(i * 7919), i);
+		ASSERT_FALSE(my_map.contains(i * 7919 + 1));
+	}
+}
+
+TEST(RobinHoodMapTest, RehashCopyTest) {
+	tech::RobinHoodMap<std::string, int> my_map = {{"a", 1}, {"b", 2}, {"c", 3}};
+	my_map.reserve(1000);
+	ASSERT_GE(my_map.bucket_count() * my_map.max_load_factor(), 1000);
+	auto copy = my_map;
+	auto moved = std::move(my_map);
+	copy.clear();
+	ASSERT_TRUE(copy.empty());
+	ASSERT_EQ(moved.size(), 3);
+	ASSERT_EQ(moved.at("b"), 2);
+	copy = moved;
+	ASSERT_EQ(copy.at("c"), 3);
+}
+
+struct RobinHoodStringHash {
+	using is_transparent = void;
+	std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+TEST(RobinHoodMapTest, TransparentLookupTest) {
+	tech::RobinHoodMap<std::string, int, RobinHoodStringHash, std::equal_to<>> my_map = {{"a", 1}, {"b", 2}};
+	std::string_view key = "a";
+	ASSERT_EQ(my_map.at(key), 1);
+	ASSERT_EQ(my_map.find(key)->first, "a");
+	ASSERT_TRUE(my_map.try_emplace(std::string_view("c"), 3).second);
+	ASSERT_FALSE(my_map.insert_or_assign(std::string_view("a"), 4).second);
+	ASSERT_EQ(my_map.at("a"), 4);
+	ASSERT_EQ(my_map.erase(std::string_view("b")), 1);
+	ASSERT_FALSE(my_map.contains("b"));
+	ASSERT_EQ(my_map.size(), 2);
+}
+
+// бросает из конструктора, пока включен throws
+struct RobinHoodThrowingValue {
+	static inline bool throws = false;
+	int value;
+	RobinHoodThrowingValue(int v = 0) : value(v) {
+		if (throws) {
+			throw std::runtime_error("RobinHoodThrowingValue");
+		}
+	}
+};
+
+TEST(RobinHoodMapTest, ThrowingConstructorTest) {
+	tech::RobinHoodMap<int, RobinHoodThrowingValue, CollidingHash> my_map(64);
+	// 140 живет в слоте 12, серия из дома 5 доходит до 11: следующий ключ из дома 5 сдвигает 140
+	my_map.try_emplace(140, 140);
+	for (int i = 0; i < 7; ++i) {
+		my_map.try_emplace(i, i);
+	}
+	ASSERT_EQ(my_map.max_probe_length(), 7);
+	RobinHoodThrowingValue::throws = true;
+	ASSERT_THROW(my_map.try_emplace(7, 7), std::runtime_error);
+	ASSERT_THROW(my_map.emplace(8, 8), std::runtime_error);
+	ASSERT_THROW(my_map[9], std::runtime_error);
+	RobinHoodThrowingValue::throws = false;
+	ASSERT_EQ(my_map.size(), 8);
+	ASSERT_EQ(my_map.max_probe_length(), 7);
+	ASSERT_EQ(my_map.at(140).value, 140);
+	for (int i = 0; i < 7; ++i) {
+		ASSERT_EQ(my_map.at(i).value, i);
+	}
+	ASSERT_FALSE(my_map.contains(7));
+	ASSERT_EQ(std::distance(my_map.begin(), my_map.end()), 8);
+	ASSERT_TRUE(my_map.try_emplace(7, 7).second);
+	ASSERT_EQ(my_map.at(140).value, 140);
+}
+
+TEST(RobinHoodMapTest, MovedFromTest) {
+	tech::RobinHoodMap<std::string, int> my_map = {{"a", 1}, {"b", 2}};
+	auto other = std::move(my_map);
+	ASSERT_TRUE(my_map.empty());
+	ASSERT_FALSE(my_map.contains("a"));
+	ASSERT_EQ(my_map.find("a"), my_map.end());
+	ASSERT_EQ(my_map.erase("a"), 0);
+	ASSERT_EQ(my_map.begin(), my_map.end());
+	ASSERT_EQ(my_map.max_probe_length(), 0);
+	my_map["c"] = 3;
+	ASSERT_EQ(my_map.at("c"), 3);
+	tech::RobinHoodMap<std::string, int> assigned;
+	assigned = std::move(other);
+	ASSERT_FALSE(other.contains("a"));
+	ASSERT_TRUE(other.try_emplace("d", 4).second);
+	ASSERT_EQ(assigned.at("b"), 2);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <libtech/static_map.hpp>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace {
+enum class Method : std::uint8_t { Get, Head, Post, Put, Delete, Connect, Options, Trace, Patch };
+
+constexpr auto METHODS = tech::make_static_map<std::string_view, Method>({{"GET", Method::Get},
+																		   {"HEAD", Method::Head},
+																		   {"POST", Method::Post},
+																		   {"PUT", Method::Put},
+																		   {"DELETE", Method::Delete},
+																		   {"CONNECT", Method::Connect},
+																		   {"OPTIONS", Method::Options},
+																		   {"TRACE", Method::Trace},
+																		   {"PATCH", Method::Patch}});
+// таблица посчитана компилятором
+static_assert(METHODS.size() == 9);
+static_assert(METHODS.at("POST") == Method::Post);
+static_assert(METHODS.contains("PATCH"));
+static_assert(!METHODS.contains("GETS"));
+static_assert(!METHODS.contains(""));
+
+constexpr auto squares() {
+	std::array<std::pair<std::uint32_t, std::uint32_t>, 500> items{};
+	for (std::uint32_t i = 0; i < items.size(); ++i) {
+		items[i] = {i * 1000003, i * i};
+	}
+	return tech::make_static_map(items);
+}
+constexpr auto SQUARES = squares();
+static_assert(SQUARES.at(499 * 1000003) == 499 * 499);
+} // namespace
+
+TEST(StaticMapTest, CompileTimeTableTest) {
+	ASSERT_EQ(METHODS.at("DELETE"), Method::Delete);
+	ASSERT_EQ(METHODS.find("TRACE")->second, Method::Trace);
+	ASSERT_EQ(METHODS.find("trace"), METHODS.end());
+	ASSERT_EQ(METHODS.count("HEAD"), 1);
+	ASSERT_THROW(METHODS.at("PURGE"), std::out_of_range);
+	// ячеек ровно столько, сколько ключей, каждый ключ на своей
+	std::set<std::string_view> names;
+	for (const auto& [name, method] : METHODS) {
+		ASSERT_EQ(METHODS.at(name), method);
+		names.insert(name);
+	}
+	ASSERT_EQ(names.size(), METHODS.size());
+
+	for (std::uint32_t i = 0; i < 500; ++i) {
+		ASSERT_EQ(SQUARES.at(i * 1000003), i * i);
+		ASSERT_FALSE(SQUARES.contains(i * 1000003 + 1));
+	}
+}
+
+TEST(StaticMapTest, RuntimeBuildTest) {
+	// та же сборка работает и в рантайме, ошибки - исключения
+	std::array<std::pair<int, int>, 3> items{{{1, 10}, {2, 20}, {1, 30}}};
+	ASSERT_THROW(tech::make_static_map(items), std::invalid_argument);
+	items[2].first = 3;
+	auto map = tech::make_static_map(items);
+	ASSERT_EQ(map.at(3), 30);
+	ASSERT_FALSE(map.contains(4));
+	auto empty = tech::make_static_map(std::array<std::pair<int, int>, 0>{});
+	ASSERT_TRUE(empty.empty());
+	ASSERT_FALSE(empty.contains(1));
+	ASSERT_EQ(empty.begin(), empty.end());
+}